@@ -0,0 +1,346 @@
+/*******     Checkpoints     *******/
+
+
+#include "os.h"
+
+#include <fstream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+**	Layout of a checkpoint file:
+**		CheckpointHeader
+**		nodeCount x (
+**			NodeHeader
+**			fsCount  x (size, addr)
+**			readyCount x PCBRecord
+**			ioCount  x PCBRecord
+**			stsCount x PCBRecord   (front of the queue first)
+**			ltsCount x LTSRecord   (in LTS order)
+**			resCount x ResRecord   (by core address)
+**		)
+*/
+
+#define CHECKPOINT_MAGIC	"SOSCKPT"
+#define CHECKPOINT_VERSION	3
+
+struct CheckpointHeader {
+	char magic[8];
+	long version;
+	long clock;
+	long timeSlice;
+	long nodeCount;
+};
+
+struct NodeHeader {
+	long drumBusy;
+	long diskBusy;
+	long runningIndex; // Position of runningJob in cpuReadyQueue, -1 if the queue is empty
+	long fsCount;
+	long readyCount;
+	long ioCount;
+	long stsCount;
+	long ltsCount;
+	long resCount;
+};
+
+struct FSRecord {
+	long size;
+	long addr;
+};
+
+struct LTSRecord {
+	long key;
+	PCBRecord job;
+};
+
+struct ResRecord {
+	long addr;
+	long jobNumber;
+};
+
+
+/*
+**			saveNode(2)
+**	-Inputs:
+**		ofstream &out, Node *node
+**	-Description:
+**		Writes one machine's free space table, every PCB in
+**		its ready, IO, short term and long term queues, its
+**		region reservations, the position of its running
+**		job and its device busy flags
+**	-Output:
+**		none
+*/
+
+void saveNode(ofstream &out, Node *node)
+{
+	NodeHeader header;
+	header.drumBusy = node->drumBusy;
+	header.diskBusy = node->diskBusy;
+	header.runningIndex = -1;
+	header.fsCount = node->memManager.getTable().size();
+	header.readyCount = node->cpuReadyQueue.size();
+	header.ioCount = node->ioQueue.size();
+	header.stsCount = node->shortTermSch.size();
+	header.ltsCount = node->longTermSch.size();
+	header.resCount = node->reservations.size();
+
+	PCBList::iterator it;
+	long index = 0;
+
+	for(it = node->cpuReadyQueue.begin(); it != node->cpuReadyQueue.end(); it++, index++)
+		if(it == node->runningJob)
+			header.runningIndex = index;
+
+	out.write((const char *)&header, sizeof(header));
+
+	FSTable::const_iterator fs;
+	for(fs = node->memManager.getTable().begin(); fs != node->memManager.getTable().end(); fs++) {
+		FSRecord rec = { fs->first, fs->second };
+		out.write((const char *)&rec, sizeof(rec));
+	}
+
+	for(it = node->cpuReadyQueue.begin(); it != node->cpuReadyQueue.end(); it++) {
+		PCBRecord rec = it->getRecord();
+		out.write((const char *)&rec, sizeof(rec));
+	}
+
+	for(it = node->ioQueue.begin(); it != node->ioQueue.end(); it++) {
+		PCBRecord rec = it->getRecord();
+		out.write((const char *)&rec, sizeof(rec));
+	}
+
+	// PCBQueue has no iterators, so walk a copy of it
+	PCBQueue sts(node->shortTermSch);
+	while(!sts.empty()) {
+		PCBRecord rec = sts.front().getRecord();
+		out.write((const char *)&rec, sizeof(rec));
+		sts.pop();
+	}
+
+	LTSMap::iterator lts;
+	for(lts = node->longTermSch.begin(); lts != node->longTermSch.end(); lts++) {
+		LTSRecord rec;
+		rec.key = lts->first;
+		rec.job = lts->second.getRecord();
+		out.write((const char *)&rec, sizeof(rec));
+	}
+
+	ReservationMap::iterator res;
+	for(res = node->reservations.begin(); res != node->reservations.end(); res++) {
+		ResRecord rec = { res->first, res->second };
+		out.write((const char *)&rec, sizeof(rec));
+	}
+}
+
+
+/*
+**			saveCheckpoint(3)
+**	-Inputs:
+**		const char *fileName, long clock, const vector<Node *> &nodes
+**	-Description:
+**		Writes the state of every machine, in order, and
+**		the clock into a binary snapshot
+**	-Output:
+**		true if the whole snapshot was written
+*/
+
+bool saveCheckpoint(const char *fileName, long clock, const vector<Node *> &nodes)
+{
+	ofstream out(fileName, ios::binary | ios::trunc);
+	if(!out)
+		return false;
+
+	CheckpointHeader header;
+	memcpy(header.magic, CHECKPOINT_MAGIC, 8);
+	header.version = CHECKPOINT_VERSION;
+	header.clock = clock;
+	header.timeSlice = TIME_SLICE;
+	header.nodeCount = nodes.size();
+	out.write((const char *)&header, sizeof(header));
+
+	for(size_t k = 0; k < nodes.size(); k++)
+		saveNode(out, nodes[k]);
+
+	return out.good();
+}
+
+
+/*
+**			nodeSize(3)
+**	-Inputs:
+**		const char *cur, size_t left, NodeHeader &header
+**	-Description:
+**		Reads the header of the machine that starts at cur
+**		and checks its counts against the bytes left
+**	-Output:
+**		bytes the machine takes, 0 if it is not valid
+*/
+
+size_t nodeSize(const char *cur, size_t left, NodeHeader &header)
+{
+	if(left < sizeof(NodeHeader))
+		return 0;
+	memcpy(&header, cur, sizeof(header));
+
+	if(header.fsCount < 0 || header.readyCount < 0 || header.ioCount < 0
+	   || header.stsCount < 0 || header.ltsCount < 0 || header.resCount < 0
+	   || header.runningIndex >= header.readyCount)
+		return 0;
+
+	size_t size = sizeof(NodeHeader)
+				+ header.fsCount * sizeof(FSRecord)
+				+ (header.readyCount + header.ioCount + header.stsCount) * sizeof(PCBRecord)
+				+ header.ltsCount * sizeof(LTSRecord)
+				+ header.resCount * sizeof(ResRecord);
+
+	return size <= left ? size : 0;
+}
+
+
+/*
+**			restoreNode(2)
+**	-Inputs:
+**		const char *cur, Node *node
+**	-Description:
+**		Rebuilds one machine from a part of the snapshot
+**		that nodeSize(3) has already checked
+**	-Output:
+**		none
+*/
+
+void restoreNode(const char *cur, Node *node)
+{
+	NodeHeader header;
+	memcpy(&header, cur, sizeof(header));
+	cur += sizeof(header);
+
+	long i;
+
+	node->memManager.clearTable();
+	for(i = 0; i < header.fsCount; i++, cur += sizeof(FSRecord)) {
+		FSRecord rec;
+		memcpy(&rec, cur, sizeof(rec));
+		node->memManager.insertInTable(pair<long,long>(rec.size, rec.addr));
+	}
+
+	node->cpuReadyQueue.clear();
+	for(i = 0; i < header.readyCount; i++, cur += sizeof(PCBRecord)) {
+		PCBRecord rec;
+		memcpy(&rec, cur, sizeof(rec));
+		node->cpuReadyQueue.push_back(PCB(rec));
+		if(i == header.runningIndex)
+			node->runningJob = --node->cpuReadyQueue.end();
+	}
+	if(header.runningIndex < 0)
+		node->runningJob = node->cpuReadyQueue.begin();
+
+	node->ioQueue.clear();
+	for(i = 0; i < header.ioCount; i++, cur += sizeof(PCBRecord)) {
+		PCBRecord rec;
+		memcpy(&rec, cur, sizeof(rec));
+		node->ioQueue.push_back(PCB(rec));
+	}
+
+	while(!node->shortTermSch.empty())
+		node->shortTermSch.pop();
+	for(i = 0; i < header.stsCount; i++, cur += sizeof(PCBRecord)) {
+		PCBRecord rec;
+		memcpy(&rec, cur, sizeof(rec));
+		node->shortTermSch.push(PCB(rec));
+	}
+
+	// Records are stored in LTS order, so every insert lands at the end
+	node->longTermSch.clear();
+	for(i = 0; i < header.ltsCount; i++, cur += sizeof(LTSRecord)) {
+		LTSRecord rec;
+		memcpy(&rec, cur, sizeof(rec));
+		node->longTermSch.insert(node->longTermSch.end(), pair<long, PCB>(rec.key, PCB(rec.job)));
+	}
+
+	node->reservations.clear();
+	node->reserveMisses.clear();
+	for(i = 0; i < header.resCount; i++, cur += sizeof(ResRecord)) {
+		ResRecord rec;
+		memcpy(&rec, cur, sizeof(rec));
+		node->reservations.insert(node->reservations.end(), pair<const long, long>(rec.addr, rec.jobNumber));
+	}
+
+	node->drumBusy = header.drumBusy;
+	node->diskBusy = header.diskBusy;
+}
+
+
+/*
+**			restoreCheckpoint(3)
+**	-Inputs:
+**		const char *fileName, long &clock, const vector<Node *> &nodes
+**	-Description:
+**		Maps the snapshot into memory and rebuilds every
+**		machine from it. The snapshot must hold as many
+**		machines as nodes, and the current state is only
+**		replaced once the whole file has been validated
+**	-Output:
+**		true if the snapshot was loaded, clock is set to
+**		the time the snapshot was taken
+*/
+
+bool restoreCheckpoint(const char *fileName, long &clock, const vector<Node *> &nodes)
+{
+	int fd = open(fileName, O_RDONLY);
+	if(fd < 0)
+		return false;
+
+	struct stat info;
+	if(fstat(fd, &info) < 0 || (size_t)info.st_size < sizeof(CheckpointHeader)) {
+		close(fd);
+		return false;
+	}
+
+	size_t fileSize = info.st_size;
+	void *base = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(base == MAP_FAILED)
+		return false;
+
+	// The snapshot is consumed front to back, once to check it and once to load it
+	madvise(base, fileSize, MADV_SEQUENTIAL);
+
+	CheckpointHeader header;
+	memcpy(&header, base, sizeof(header));
+
+	bool valid = memcmp(header.magic, CHECKPOINT_MAGIC, 8) == 0 && header.version == CHECKPOINT_VERSION
+				 && header.nodeCount == (long)nodes.size();
+	vector<size_t> offsets;
+	size_t used = sizeof(CheckpointHeader);
+
+	for(long k = 0; valid && k < header.nodeCount; k++) {
+		NodeHeader node;
+		size_t size = nodeSize((const char *)base + used, fileSize - used, node);
+
+		offsets.push_back(used);
+		used += size;
+		valid = size > 0;
+	}
+
+	if(!valid || used != fileSize) {
+		munmap(base, fileSize);
+		return false;
+	}
+
+	for(size_t k = 0; k < nodes.size(); k++)
+		restoreNode((const char *)base + offsets[k], nodes[k]);
+
+	TIME_SLICE = header.timeSlice;
+	clock = header.clock;
+
+	munmap(base, fileSize);
+	return true;
+}
+
+
+/*******     End Checkpoints     *******/
@@ -0,0 +1,1472 @@
+/*******     Scripted Driver     *******/
+
+
+#include "os.h"
+
+#include <vector>
+#include <unordered_map>
+#include <set>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#include <thread>
+#include <barrier>
+#include <memory>
+
+/*
+**	Stand-in for the job spooler object file. It owns the
+**	clock, the CPU, the disk and the drum, raises the five
+**	interrupts and runs every job from a JobProgram. A job
+**	is resumed whenever it is on the CPU and needs its next
+**	action, and stays suspended at each Svc(2) it issues.
+**	Link it instead of the object file:
+**		g++ -std=c++20 -pthread *.cpp -o sos
+**
+**	With -N the run models a cluster of machines, each with
+**	its own Node, CPU, disk and drum. A router picks the
+**	machine for every arriving job (-r), whether it was
+**	made up, read from a file or fed live (-f). With -m
+**	jobs waiting in one machine's LTS move to a machine
+**	that has room for them
+**
+**	Machines only affect each other through the router and
+**	through migration, and both act at syncs that happen
+**	every syncWindow ticks. In between, each machine handles
+**	its own events up to the end of the window without
+**	looking at the others. The window is part of the
+**	cluster model, not a lookahead taken from device
+**	service times: routing and migration only see the
+**	machines as they were at the last sync. With -p every
+**	machine runs its windows on a thread of its own. The
+**	sequential run goes through the same windows one
+**	machine after another, so the output is the same
+**	either way
+**
+**	-p does not split a single machine. Every interrupt
+**	handler works on the one Node's ready queue, memory and
+**	LTS, and the driver knows when a disk or drum transfer
+**	ends as soon as it starts it, so a device has nothing
+**	to do on a thread of its own. A run with one node uses
+**	one thread with or without -p
+**
+**	-C saves the whole run at a sync, the OS state with
+**	saveCheckpoint() and the driver's own state next to
+**	it, and -R resumes from such a save. -V restores the
+**	save right away and stops if saving it again does not
+**	give the same files
+*/
+
+// Event kinds, in the order they are handled when they share a clock value
+#define EV_DRUM		1
+#define EV_DISK		2
+#define EV_ARRIVAL	3
+#define EV_CPU		4
+
+#define DRUM_BASE_TIME	5 // Drum time is DRUM_BASE_TIME plus one tick per K swapped
+#define MEMORY_SIZE		100
+#define SYNC_WINDOW		1000 // Default ticks between syncs of the machines
+
+void startup();
+void Crint(long &a, long p[]);
+void Drmint(long &a, long p[]);
+void Dskint(long &a, long p[]);
+void Tro(long &a, long p[]);
+void Svc(long &a, long p[]);
+
+struct SimJob {
+	long number;
+	long priority;
+	long size;
+	long maxCPU;
+	long arrival;
+
+	JobProgram program;
+	long steps; // Actions taken from program so far, replayed to rebuild it after a restore
+	long burstLeft; // CPU time left in the current burst
+	long cpuUsed;
+	long pendingSvc; // Svc(2) request waiting to be raised, 0 if none
+	pmr::list<long> ioTimes; // Disk time of each IO requested but not started yet
+	long ioRequested;
+	long ioDone;
+	bool finished;
+
+	SimJob(): number(0), priority(0), size(0), maxCPU(0), arrival(0),
+			  steps(0), burstLeft(0), cpuUsed(0), pendingSvc(0), ioTimes(&simPool), ioRequested(0), ioDone(0), finished(false) {}
+};
+
+struct Event {
+	long time;
+	long kind;
+	long seq; // Keeps events of the same time and kind in the order they were posted
+	long job;
+
+	bool operator >(const Event &rObj) const {
+		if(time != rObj.time)
+			return time > rObj.time;
+		if(kind != rObj.kind)
+			return kind > rObj.kind;
+		return seq > rObj.seq;
+	}
+};
+
+// A termination report, held until the next sync so reports from all machines come out in time order
+struct OutputLine {
+	long time;
+	string text;
+};
+
+// One simulated machine: its OS state and the hardware the driver models for it
+struct Machine {
+	long index;
+	Node *os;
+	unique_ptr<Node> ownNode; // Owns os on every machine but the first
+
+	priority_queue<Event, vector<Event>, greater<Event> > events;
+	long nextSeq;
+	long clock; // Time of the event being handled
+	vector<OutputLine> output;
+
+	long regA; // Registers shared with the interrupt handlers
+	long regP[6];
+	unordered_map<long, long> jobAtAddr; // Core address -> index of the job swapped in there
+
+	long cpuJob; // Job on the CPU, -1 if idle
+	long cpuStart; // Time the current CPU segment started
+	long quantumLeft;
+	long cpuEventSeq; // Only the CPU event with this seq is still valid
+	long diskJob;
+
+	long cpuBusy, diskBusyTime, drumBusyTime;
+	long routed, terminated, totalResponse;
+};
+
+//Driver State
+vector<SimJob> jobs; // A job is only touched by the machine it was routed to, or at a sync
+unordered_map<long, long> jobIndex; // Job number -> index in jobs
+vector<unique_ptr<Machine> > machines;
+thread_local Machine *mach; // Machine whose event this thread is handling
+
+bool quiet = false;
+unsigned long scriptSeed = 1;
+bool migrate = false;
+long migrations = 0;
+
+//Cluster Engine State
+bool parallel = false;
+long syncWindow = SYNC_WINDOW;
+long windowEnd = 0; // Machines handle their events before this time, then sync
+vector<long> arrivalOrder; // Jobs by arrival time
+size_t nextArrival = 0; // Next entry of arrivalOrder to route
+bool running = false; // Cleared by the sync that finds nothing left to do
+const char *checkpointFile = NULL; // Run is saved here at the first sync at or after checkpointAt (-C)
+long checkpointAt = 0;
+bool verifyCheckpoint = false; // Restore the save right away and check it saves the same again (-V)
+bool feeding = false; // Jobs come from the live feed (-f) instead of being made up front
+long feedPace = 0; // Microseconds of wall-clock time per tick with -t, 0 runs the feed flat out
+
+//Router State, only used at syncs
+unsigned long routeState; // Random state of the p2c router
+long routeNext = 0; // Machine the rr router sends the next job to
+bool routeStale = true; // Set at every sync, the snapshot below is retaken before the next job is routed
+vector<long> routeLoad; // Load of each machine as of the last sync, plus the jobs routed since
+vector<multiset<long> > routeFree; // Free block sizes of each machine, less the blocks routed jobs will take
+
+
+void postEvent(long time, long kind, long job)
+{
+	Event ev = { time, kind, mach->nextSeq++, job };
+	mach->events.push(ev);
+	if(kind == EV_CPU)
+		mach->cpuEventSeq = ev.seq;
+}
+
+/*
+**                       jobSlot(1)
+**
+**    Index in jobs of a job number the OS hands back.
+**    A number the driver never created means the two
+**    disagree about the workload, so the run stops
+*/
+long jobSlot(long jobNum)
+{
+	unordered_map<long, long>::iterator it = jobIndex.find(jobNum);
+
+	if(it == jobIndex.end()) {
+		cerr << "OS referred to job " << jobNum << ", which the driver does not know" << endl;
+		exit(1);
+	}
+	return it->second;
+}
+
+/*
+**                       siodisk(1)
+**
+**    Starts the next IO the job asked for. The disk stays
+**    busy for the time given in the job's ioRequest
+*/
+void siodisk(long jobNum)
+{
+	SimJob &job = jobs[jobSlot(jobNum)];
+	long ticks = 1;
+
+	if(!job.ioTimes.empty()) {
+		ticks = job.ioTimes.front();
+		job.ioTimes.pop_front();
+	}
+
+	mach->diskJob = jobSlot(jobNum);
+	mach->diskBusyTime += ticks;
+	postEvent(mach->clock + ticks, EV_DISK, mach->diskJob);
+}
+
+/*
+**                       siodrum(4)
+**
+**    Starts a swap. Remembers which job now lives at
+**    coreAddr so the dispatcher's p[2] can be mapped back
+*/
+void siodrum(long jobNum, long jobSize, long coreAddr, long direction)
+{
+	long ticks = DRUM_BASE_TIME + jobSize;
+
+	if(direction == 0)
+		mach->jobAtAddr[coreAddr] = jobSlot(jobNum);
+
+	mach->drumBusyTime += ticks;
+	postEvent(mach->clock + ticks, EV_DRUM, jobSlot(jobNum));
+}
+
+void ontrace() {}
+void offtrace() {}
+
+/*
+**                      accountCPU(0)
+**
+**    Charges the time since the last segment started to
+**    the job on the CPU
+*/
+void accountCPU()
+{
+	if(mach->cpuJob < 0)
+		return;
+
+	long ran = mach->clock - mach->cpuStart;
+	jobs[mach->cpuJob].cpuUsed += ran;
+	jobs[mach->cpuJob].burstLeft -= ran;
+	mach->quantumLeft -= ran;
+	mach->cpuBusy += ran;
+	mach->cpuStart = mach->clock;
+}
+
+/*
+**                      nextAction(1)
+**
+**    Resumes the job until it has either a CPU burst
+**    to run or a Svc(2) request to make
+*/
+void nextAction(SimJob &job)
+{
+	JobAction act;
+
+	while(job.burstLeft <= 0 && job.pendingSvc == 0) {
+		job.steps++;
+		if(!job.program.next(act)) {
+			job.program.release();
+			job.pendingSvc = 5;
+		}
+		else if(act.kind == JOB_CPU)
+			job.burstLeft = act.amount;
+		else {
+			if(act.kind == JOB_IO)
+				job.ioTimes.push_back(act.amount);
+			job.pendingSvc = act.kind;
+		}
+	}
+}
+
+/*
+**                      scheduleCPU(0)
+**
+**    Posts the next CPU event for the running job: the
+**    end of its burst, its quantum or its max cpu time,
+**    whichever comes first
+*/
+void scheduleCPU()
+{
+	SimJob &job = jobs[mach->cpuJob];
+
+	if(job.finished) {
+		postEvent(mach->clock, EV_CPU, mach->cpuJob);
+		return;
+	}
+
+	nextAction(job);
+	if(job.pendingSvc != 0) {
+		postEvent(mach->clock, EV_CPU, mach->cpuJob);
+		return;
+	}
+
+	long run = job.burstLeft;
+	if(mach->quantumLeft < run)
+		run = mach->quantumLeft;
+	if(job.maxCPU - job.cpuUsed < run)
+		run = job.maxCPU - job.cpuUsed;
+	if(run < 0)
+		run = 0;
+
+	postEvent(mach->clock + run, EV_CPU, mach->cpuJob);
+}
+
+/*
+**                      interrupt(1)
+**
+**    Raises one interrupt and then gives the CPU to
+**    whatever the handler put in the registers
+*/
+void interrupt(void (*handler)(long &, long []))
+{
+	accountCPU();
+	mach->regP[5] = mach->clock;
+	handler(mach->regA, mach->regP);
+
+	mach->cpuEventSeq = -1;
+	if(mach->regA == 2 && mach->jobAtAddr.count(mach->regP[2])) {
+		mach->cpuJob = mach->jobAtAddr[mach->regP[2]];
+		mach->cpuStart = mach->clock;
+		mach->quantumLeft = mach->regP[4] > 0 ? mach->regP[4] : 1;
+		scheduleCPU();
+	}
+	else
+		mach->cpuJob = -1;
+}
+
+/*
+**                      reportTermination(2)
+**
+**    Writes a job's termination in the spooler's format.
+**    The report is printed at the next sync
+*/
+void reportTermination(SimJob &job, bool normal)
+{
+	job.finished = true;
+	mach->terminated++;
+	mach->totalResponse += mach->clock - job.arrival;
+
+	if(quiet)
+		return;
+
+	ostringstream out;
+	out << " *** Clock :  " << mach->clock << "   job   " << job.number << "  terminated  "
+		<< (normal ? "normally (terminate svc issued) " : "abnormally (max cpu time exceeded) ") << endl;
+	out << "   response time : " << mach->clock - job.arrival << "  CPU Time : " << job.cpuUsed
+		<< "   # I/O operations completed:  " << job.ioDone;
+	if(machines.size() > 1)
+		out << "   node : " << mach->index;
+	out << endl;
+	out << " # I/O operations pending :  " << job.ioRequested - job.ioDone << " " << endl << endl << endl;
+
+	OutputLine line = { mach->clock, out.str() };
+	mach->output.push_back(line);
+}
+
+/*
+**                      cpuEvent(0)
+**
+**    The running job finished a burst, used up its
+**    quantum or hit its max cpu time
+*/
+void cpuEvent()
+{
+	accountCPU();
+	SimJob &job = jobs[mach->cpuJob];
+
+	if(job.finished) {
+		// Job already reported but the OS still runs it, take it off for good
+		mach->regA = 5;
+		interrupt(Svc);
+		return;
+	}
+
+	if(job.burstLeft <= 0)
+		nextAction(job);
+
+	if(job.pendingSvc != 0) {
+		mach->regA = job.pendingSvc;
+		job.pendingSvc = 0;
+		if(mach->regA == JOB_IO)
+			job.ioRequested++;
+		if(mach->regA == 5) {
+			job.program.release();
+			reportTermination(job, true);
+		}
+		interrupt(Svc);
+	}
+	else if(job.cpuUsed >= job.maxCPU) {
+		job.program.release();
+		reportTermination(job, false);
+		interrupt(Tro);
+	}
+	else if(mach->quantumLeft <= 0)
+		interrupt(Tro);
+	else
+		scheduleCPU();
+}
+
+/*
+**                      loadJobs(1)
+**
+**    Reads jobs (job number, priority, size, max cpu
+**    time, arrival time) from a file, one per line. Job
+**    numbers must be unique, since the OS refers to jobs
+**    by number, and sizes and max cpu times must be above
+**    zero. A line that is not a job stops the load
+*/
+bool loadJobs(const char *fileName)
+{
+	ifstream in(fileName);
+	string line;
+	long lineNum = 0;
+
+	if(!in) {
+		cerr << "cannot read " << fileName << endl;
+		return false;
+	}
+
+	while(getline(in, line)) {
+		istringstream fields(line);
+		SimJob job;
+		string extra;
+
+		lineNum++;
+		if(!(fields >> ws) || fields.eof())
+			continue; // Blank line
+
+		if(!(fields >> job.number >> job.priority >> job.size >> job.maxCPU >> job.arrival) || fields >> extra) {
+			cerr << fileName << ":" << lineNum << ": expected job number, priority, size, max cpu time, arrival time" << endl;
+			return false;
+		}
+		if(job.size <= 0 || job.maxCPU <= 0) {
+			cerr << fileName << ":" << lineNum << ": job " << job.number << " needs a size and max cpu time above zero" << endl;
+			return false;
+		}
+		if(jobIndex.count(job.number)) {
+			cerr << fileName << ":" << lineNum << ": job " << job.number << " appears more than once" << endl;
+			return false;
+		}
+
+		jobIndex[job.number] = jobs.size();
+		jobs.push_back(SimJob());
+		jobs.back().number = job.number;
+		jobs.back().priority = job.priority;
+		jobs.back().size = job.size;
+		jobs.back().maxCPU = job.maxCPU;
+		jobs.back().arrival = job.arrival;
+	}
+	if(in.bad()) {
+		cerr << "error reading " << fileName << endl;
+		return false;
+	}
+	return true;
+}
+
+/*
+**                      makeJobs(3)
+**
+**    Generates count jobs that arrive on average every
+**    meanGap ticks, with sizes and max cpu times in the
+**    range the spooler uses
+*/
+void makeJobs(long count, unsigned long seed, long meanGap)
+{
+	unsigned long state = seed * 0x9E3779B97F4A7C15UL + 1;
+	long arrival = 0;
+
+	jobs.reserve(count);
+	for(long i = 1; i <= count; i++) {
+		state ^= state >> 12; state ^= state << 25; state ^= state >> 27;
+		unsigned long r = state * 2685821657736338717UL;
+
+		jobIndex[i] = jobs.size();
+		jobs.push_back(SimJob());
+		SimJob &job = jobs.back();
+		job.number = i;
+		job.priority = 1 + r % 5;
+		job.size = 1 + (r >> 8) % 50;
+		job.maxCPU = 10L << ((r >> 16) % 10);
+		job.arrival = arrival;
+		arrival += (r >> 24) % (2 * meanGap);
+	}
+}
+
+/*
+**                      newMachine(2)
+**
+**    Sets up a machine with its devices idle. Machine 0
+**    runs on the Node os.cpp starts out with, the others
+**    get a Node of their own
+*/
+unique_ptr<Machine> newMachine(long index)
+{
+	unique_ptr<Machine> m(new Machine());
+
+	m->index = index;
+	if(index > 0)
+		m->ownNode.reset(new Node());
+	m->os = index > 0 ? m->ownNode.get() : curNode;
+	m->cpuJob = -1;
+	m->cpuEventSeq = -1;
+	m->diskJob = -1;
+	return m;
+}
+
+/*
+**                      selectMachine(1)
+**
+**    Points this thread's driver and OS at machine k
+*/
+void selectMachine(long k)
+{
+	mach = machines[k].get();
+	curNode = mach->os;
+}
+
+// Jobs a machine has taken on and not finished: ready, waiting for the drum or waiting for memory
+long machineLoad(long k)
+{
+	Node *os = machines[k]->os;
+
+	return os->cpuReadyQueue.size() + os->shortTermSch.size() + os->longTermSch.size();
+}
+
+/*
+**                      snapshotRouter(0)
+**
+**    Copies each machine's load and free blocks for the
+**    router. Machines are only looked at between windows,
+**    so jobs routed in the same window see the snapshot
+**    plus the jobs routed before them
+*/
+void snapshotRouter()
+{
+	routeStale = false;
+	routeLoad.assign(machines.size(), 0);
+	routeFree.assign(machines.size(), multiset<long>());
+
+	for(size_t k = 0; k < machines.size(); k++) {
+		const FSTable &table = machines[k]->os->memManager.getTable();
+
+		routeLoad[k] = machineLoad(k);
+		for(FSTable::const_iterator fs = table.begin(); fs != table.end(); fs++)
+			routeFree[k].insert(fs->first);
+	}
+}
+
+/*
+**                      Routing policies(1)
+**
+**    Each picks the machine an arriving job is sent to
+*/
+typedef long (*RoutePolicy)(const SimJob &job);
+
+long routeRoundRobin(const SimJob &)
+{
+	long k = routeNext;
+
+	routeNext = (routeNext + 1) % machines.size();
+	return k;
+}
+
+long routeLeastLoaded(const SimJob &)
+{
+	long best = 0;
+
+	for(size_t k = 1; k < machines.size(); k++)
+		if(routeLoad[k] < routeLoad[best])
+			best = k;
+	return best;
+}
+
+// Machine whose smallest free block that holds the job is the tightest, least loaded if none has one
+long routeBestFit(const SimJob &job)
+{
+	long best = -1, bestBlock = LONG_MAX;
+
+	for(size_t k = 0; k < machines.size(); k++) {
+		multiset<long>::const_iterator fs = routeFree[k].lower_bound(job.size);
+
+		if(fs != routeFree[k].end() && *fs < bestBlock) {
+			best = k;
+			bestBlock = *fs;
+		}
+	}
+	return best >= 0 ? best : routeLeastLoaded(job);
+}
+
+// Less loaded of two machines picked at random
+long routePowerOfTwo(const SimJob &)
+{
+	long n = machines.size();
+
+	if(n == 1)
+		return 0;
+
+	routeState ^= routeState >> 12; routeState ^= routeState << 25; routeState ^= routeState >> 27;
+	unsigned long r = routeState * 2685821657736338717UL;
+	long a = r % n;
+	long b = (a + 1 + (r >> 32) % (n - 1)) % n;
+
+	return routeLoad[b] < routeLoad[a] ? b : a;
+}
+
+struct RouteName {
+	const char *name;
+	RoutePolicy policy;
+};
+
+RouteName routePolicies[] = {
+	{ "rr", routeRoundRobin },
+	{ "ll", routeLeastLoaded },
+	{ "fit", routeBestFit },
+	{ "p2c", routePowerOfTwo },
+	{ NULL, NULL }
+};
+
+RoutePolicy route = routeLeastLoaded;
+
+/*
+**                      routeJob(1)
+**
+**    Sends a job to the machine the router picks and
+**    posts its arrival there. The snapshot is updated
+**    as the machine will see the job: one more load and,
+**    if a block holds it, that block cut down to the rest
+*/
+void routeJob(long index)
+{
+	SimJob &job = jobs[index];
+
+	if(job.size > MEMORY_SIZE) {
+		cerr << "job " << job.number << " does not fit in memory, skipped" << endl;
+		return;
+	}
+	if(routeStale)
+		snapshotRouter();
+
+	long k = route(job);
+	multiset<long>::iterator fs = routeFree[k].lower_bound(job.size);
+
+	routeLoad[k]++;
+	if(fs != routeFree[k].end()) {
+		long rest = *fs - job.size;
+		routeFree[k].erase(fs);
+		if(rest > 0)
+			routeFree[k].insert(rest);
+	}
+
+	// Arrivals keep their index as seq, as when they were all posted before the run
+	Event ev = { job.arrival, EV_ARRIVAL, index, index };
+	machines[k]->events.push(ev);
+	machines[k]->routed++;
+}
+
+/*
+**                      nextFedArrival(1)
+**
+**    Earliest time a fed job can still arrive. Flat out,
+**    blocks until the feed has a job in the ring or has
+**    read all of its input, so a sync never opens a
+**    window before it knows whether a fed job falls in
+**    it. Paced, the clock follows the wall clock whether
+**    or not the feed has anything, so a job not in the
+**    ring yet arrives no earlier than the wall clock's
+**    tick
+**	-Output:
+**		false once the feed is finished
+*/
+bool nextFedArrival(long &arrival)
+{
+	if(nextFeedArrival(arrival))
+		return true;
+	if(jobFeedFinished())
+		return false;
+	if(feedPace > 0) {
+		arrival = feedClock();
+		return true;
+	}
+	return waitFeedJob(arrival);
+}
+
+/*
+**                      routeFedJobs(1)
+**
+**    Takes every fed job that arrives before the end of
+**    the window, gives it a SimJob and routes it like a
+**    made-up job. A job that shows up after its arrival
+**    time has passed arrives at the start of the window
+*/
+void routeFedJobs(long start)
+{
+	JobRecord rec;
+	long arrival;
+
+	while(nextFedArrival(arrival) && arrival < windowEnd && takeFedJob(windowEnd, rec)) {
+		if(jobIndex.count(rec.jobNumber)) {
+			cerr << "feed: job " << rec.jobNumber << " appears more than once, skipped" << endl;
+			continue;
+		}
+		if(rec.jobSize <= 0 || rec.maxCPUTime <= 0) {
+			cerr << "feed: job " << rec.jobNumber << " needs a size and max cpu time above zero, skipped" << endl;
+			continue;
+		}
+
+		jobIndex[rec.jobNumber] = jobs.size();
+		jobs.push_back(SimJob());
+		SimJob &job = jobs.back();
+		job.number = rec.jobNumber;
+		job.priority = rec.priority;
+		job.size = rec.jobSize;
+		job.maxCPU = rec.maxCPUTime;
+		job.arrival = rec.timeOfArrival > start ? rec.timeOfArrival : start;
+		routeJob(jobs.size() - 1);
+	}
+}
+
+/*
+**                      balanceWaitingJobs(1)
+**
+**    Moves jobs waiting for memory to machines that have
+**    nothing waiting and a free block they fit in. Each
+**    idle machine takes at most one job per sync, from
+**    the machine with the longest LTS. The swap-in starts
+**    on the new machine at the sync time now
+*/
+void balanceWaitingJobs(long now)
+{
+	for(size_t dest = 0; dest < machines.size(); dest++) {
+		Node *os = machines[dest]->os;
+
+		if(!os->longTermSch.empty() || !os->shortTermSch.empty() || os->memManager.getTable().empty())
+			continue;
+
+		long src = -1;
+		for(size_t k = 0; k < machines.size(); k++)
+			if(!machines[k]->os->longTermSch.empty()
+			   && (src < 0 || machines[k]->os->longTermSch.size() > machines[src]->os->longTermSch.size()))
+				src = k;
+		if(src < 0)
+			break;
+
+		PCB job;
+		selectMachine(src);
+		if(takeWaitingJob(os->memManager.getTable().rbegin()->first, job)) {
+			selectMachine(dest);
+			mach->clock = now;
+			acceptJob(job);
+			migrations++;
+		}
+	}
+}
+
+/*
+**                      handleEvent(1)
+**
+**    Advances the machine's clock to the event and
+**    raises the interrupt that goes with it
+*/
+void handleEvent(const Event &ev)
+{
+	mach->clock = ev.time;
+
+	switch(ev.kind) {
+		case EV_ARRIVAL: {
+			SimJob &job = jobs[ev.job];
+
+			job.program = makeJobProgram(job.number, job.maxCPU, scriptSeed);
+			mach->regP[1] = job.number;
+			mach->regP[2] = job.priority;
+			mach->regP[3] = job.size;
+			mach->regP[4] = job.maxCPU;
+			interrupt(Crint);
+			break;
+		}
+		case EV_DRUM:
+			interrupt(Drmint);
+			break;
+		case EV_DISK:
+			jobs[ev.job].ioDone++;
+			interrupt(Dskint);
+			break;
+		case EV_CPU:
+			cpuEvent();
+			break;
+	}
+}
+
+/*
+**                      runWindow(1)
+**
+**    Handles machine k's events that come before the
+**    end of the window, in time order
+*/
+void runWindow(long k)
+{
+	selectMachine(k);
+
+	while(!mach->events.empty() && mach->events.top().time < windowEnd) {
+		Event ev = mach->events.top();
+		mach->events.pop();
+
+		if(ev.kind == EV_CPU && ev.seq != mach->cpuEventSeq)
+			continue; // CPU was taken away before this event came due
+
+		handleEvent(ev);
+	}
+}
+
+/*
+**                      flushOutput(0)
+**
+**    Prints the reports the machines made during the
+**    window, in time order
+*/
+void flushOutput()
+{
+	vector<OutputLine> lines;
+
+	for(size_t k = 0; k < machines.size(); k++) {
+		lines.insert(lines.end(), machines[k]->output.begin(), machines[k]->output.end());
+		machines[k]->output.clear();
+	}
+	stable_sort(lines.begin(), lines.end(), [](const OutputLine &x, const OutputLine &y) { return x.time < y.time; });
+
+	for(size_t i = 0; i < lines.size(); i++)
+		cout << lines[i].text;
+}
+
+/*
+**                      sortArrivals(0)
+**
+**    Lists the jobs by arrival time for the syncs to
+**    route. Jobs that arrive together keep their order
+*/
+void sortArrivals()
+{
+	arrivalOrder.resize(jobs.size());
+	for(size_t i = 0; i < arrivalOrder.size(); i++)
+		arrivalOrder[i] = i;
+	stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [](long x, long y) { return jobs[x].arrival < jobs[y].arrival; });
+}
+
+/*
+**	Layout of the driver's half of a saved run, next to
+**	the OS checkpoint of every node:
+**		RunHeader
+**		jobCount x (JobRunRecord, ioCount x disk time)
+**		nodeCount x (
+**			MachineRunRecord
+**			addrCount x (core address, job index)   (by address)
+**			eventCount x Event                      (in the order they come due)
+**		)
+**	Coroutines cannot be written out, so each job keeps
+**	how many actions it has taken and its program is made
+**	again and run that far on restore
+*/
+
+#define RUN_MAGIC	"SOSDRUN"
+#define RUN_VERSION	1
+
+struct RunHeader {
+	char magic[8];
+	long version;
+	long windowEnd;
+	long nextArrival;
+	unsigned long routeState;
+	long routeNext;
+	long migrations;
+	unsigned long scriptSeed;
+	long syncWindow;
+	long migrate;
+	long reserveRegions;
+	long policy; // Index in routePolicies
+	long nodeCount;
+	long jobCount;
+};
+
+struct JobRunRecord {
+	long number;
+	long priority;
+	long size;
+	long maxCPU;
+	long arrival;
+	long steps; // -1 if the job has no program
+	long burstLeft;
+	long cpuUsed;
+	long pendingSvc;
+	long ioRequested;
+	long ioDone;
+	long finished;
+	long ioCount;
+};
+
+struct MachineRunRecord {
+	long clock;
+	long nextSeq;
+	long regA;
+	long regP[6];
+	long cpuJob;
+	long cpuStart;
+	long quantumLeft;
+	long cpuEventSeq;
+	long diskJob;
+	long cpuBusy, diskBusyTime, drumBusyTime;
+	long routed, terminated, totalResponse;
+	long addrCount;
+	long eventCount;
+};
+
+// Node of every machine, in order, for the OS checkpoint
+vector<Node *> machineNodes()
+{
+	vector<Node *> nodes;
+
+	for(size_t k = 0; k < machines.size(); k++)
+		nodes.push_back(machines[k]->os);
+	return nodes;
+}
+
+/*
+**                      saveRun(1)
+**
+**    Saves the whole run at a sync: every node's OS state
+**    to fileName and the driver's state to fileName.run.
+**    Must only be called between windows
+*/
+bool saveRun(const char *fileName)
+{
+	if(!saveCheckpoint(fileName, windowEnd, machineNodes()))
+		return false;
+
+	ofstream out((string(fileName) + ".run").c_str(), ios::binary | ios::trunc);
+	if(!out)
+		return false;
+
+	RunHeader header;
+	memcpy(header.magic, RUN_MAGIC, 8);
+	header.version = RUN_VERSION;
+	header.windowEnd = windowEnd;
+	header.nextArrival = nextArrival;
+	header.routeState = routeState;
+	header.routeNext = routeNext;
+	header.migrations = migrations;
+	header.scriptSeed = scriptSeed;
+	header.syncWindow = syncWindow;
+	header.migrate = migrate;
+	header.reserveRegions = reserveRegions;
+	for(header.policy = 0; routePolicies[header.policy].policy != route; header.policy++);
+	header.nodeCount = machines.size();
+	header.jobCount = jobs.size();
+	out.write((const char *)&header, sizeof(header));
+
+	for(size_t i = 0; i < jobs.size(); i++) {
+		SimJob &job = jobs[i];
+		JobRunRecord rec = { job.number, job.priority, job.size, job.maxCPU, job.arrival,
+							 job.program.loaded() ? job.steps : -1, job.burstLeft, job.cpuUsed, job.pendingSvc,
+							 job.ioRequested, job.ioDone, job.finished, (long)job.ioTimes.size() };
+		out.write((const char *)&rec, sizeof(rec));
+
+		for(pmr::list<long>::iterator io = job.ioTimes.begin(); io != job.ioTimes.end(); io++)
+			out.write((const char *)&*io, sizeof(long));
+	}
+
+	for(size_t k = 0; k < machines.size(); k++) {
+		Machine *m = machines[k].get();
+		MachineRunRecord rec = { m->clock, m->nextSeq, m->regA,
+								 { m->regP[0], m->regP[1], m->regP[2], m->regP[3], m->regP[4], m->regP[5] },
+								 m->cpuJob, m->cpuStart, m->quantumLeft, m->cpuEventSeq, m->diskJob,
+								 m->cpuBusy, m->diskBusyTime, m->drumBusyTime, m->routed, m->terminated, m->totalResponse,
+								 (long)m->jobAtAddr.size(), (long)m->events.size() };
+		out.write((const char *)&rec, sizeof(rec));
+
+		// Sorted, so the same run always gives the same bytes
+		map<long, long> addrs(m->jobAtAddr.begin(), m->jobAtAddr.end());
+		for(map<long, long>::iterator a = addrs.begin(); a != addrs.end(); a++) {
+			long pair[2] = { a->first, a->second };
+			out.write((const char *)pair, sizeof(pair));
+		}
+
+		priority_queue<Event, vector<Event>, greater<Event> > events(m->events);
+		while(!events.empty()) {
+			out.write((const char *)&events.top(), sizeof(Event));
+			events.pop();
+		}
+	}
+
+	return out.good();
+}
+
+/*
+**                      restoreRun(1)
+**
+**    Replaces the run with one saveRun(1) wrote. With no
+**    machines set up yet, as when resuming, it sets up as
+**    many as the run had. The driver's file is read and
+**    checked before any state is replaced
+*/
+bool restoreRun(const char *fileName)
+{
+	ifstream in((string(fileName) + ".run").c_str(), ios::binary);
+	RunHeader header;
+
+	if(!in.read((char *)&header, sizeof(header)) || memcmp(header.magic, RUN_MAGIC, 8) != 0
+	   || header.version != RUN_VERSION || header.nodeCount <= 0 || header.jobCount < 0
+	   || header.policy < 0 || header.policy >= (long)(sizeof(routePolicies) / sizeof(routePolicies[0])) - 1
+	   || header.nextArrival < 0 || header.nextArrival > header.jobCount || header.syncWindow <= 0
+	   || (!machines.empty() && header.nodeCount != (long)machines.size()))
+		return false;
+
+	vector<JobRunRecord> jobRecs(header.jobCount);
+	vector<vector<long> > ioTimes(header.jobCount);
+	vector<MachineRunRecord> machRecs(header.nodeCount);
+	vector<vector<long> > addrs(header.nodeCount);
+	vector<vector<Event> > events(header.nodeCount);
+	bool valid = true;
+
+	// A job index of -1 stands for no job
+	auto validJob = [&](long index) { return index >= -1 && index < header.jobCount; };
+
+	// Lists are read one entry at a time, so a bad count runs into the end of the file
+	for(long i = 0; valid && i < header.jobCount; i++) {
+		valid = in.read((char *)&jobRecs[i], sizeof(JobRunRecord)) && jobRecs[i].ioCount >= 0;
+		for(long n = 0; valid && n < jobRecs[i].ioCount; n++) {
+			long ticks;
+			valid = (bool)in.read((char *)&ticks, sizeof(ticks));
+			ioTimes[i].push_back(ticks);
+		}
+	}
+	for(long k = 0; valid && k < header.nodeCount; k++) {
+		MachineRunRecord &rec = machRecs[k];
+
+		valid = in.read((char *)&rec, sizeof(rec)) && rec.addrCount >= 0 && rec.eventCount >= 0
+				&& validJob(rec.cpuJob) && validJob(rec.diskJob);
+		for(long n = 0; valid && n < rec.addrCount; n++) {
+			long pair[2];
+			valid = in.read((char *)pair, sizeof(pair)) && pair[1] >= 0 && validJob(pair[1]);
+			addrs[k].push_back(pair[0]);
+			addrs[k].push_back(pair[1]);
+		}
+		for(long n = 0; valid && n < rec.eventCount; n++) {
+			Event ev;
+			valid = in.read((char *)&ev, sizeof(ev)) && ev.job >= 0 && validJob(ev.job);
+			events[k].push_back(ev);
+		}
+	}
+	if(!valid || in.peek() != EOF)
+		return false;
+
+	if(machines.empty()) {
+		for(long k = 0; k < header.nodeCount; k++) {
+			machines.push_back(newMachine(k));
+			selectMachine(k);
+			startup();
+		}
+	}
+
+	long clock;
+	if(!restoreCheckpoint(fileName, clock, machineNodes()))
+		return false;
+
+	windowEnd = header.windowEnd;
+	nextArrival = header.nextArrival;
+	routeState = header.routeState;
+	routeNext = header.routeNext;
+	migrations = header.migrations;
+	scriptSeed = header.scriptSeed;
+	syncWindow = header.syncWindow;
+	migrate = header.migrate;
+	reserveRegions = header.reserveRegions;
+	route = routePolicies[header.policy].policy;
+	routeStale = true;
+
+	// Coroutine frames go back to simPool before the jobs are made again
+	jobs.clear();
+	jobIndex.clear();
+	jobs.reserve(header.jobCount);
+	for(long i = 0; i < header.jobCount; i++) {
+		JobRunRecord &rec = jobRecs[i];
+
+		jobIndex[rec.number] = jobs.size();
+		jobs.push_back(SimJob());
+		SimJob &job = jobs.back();
+		job.number = rec.number;
+		job.priority = rec.priority;
+		job.size = rec.size;
+		job.maxCPU = rec.maxCPU;
+		job.arrival = rec.arrival;
+		job.burstLeft = rec.burstLeft;
+		job.cpuUsed = rec.cpuUsed;
+		job.pendingSvc = rec.pendingSvc;
+		job.ioRequested = rec.ioRequested;
+		job.ioDone = rec.ioDone;
+		job.finished = rec.finished;
+		job.ioTimes.assign(ioTimes[i].begin(), ioTimes[i].end());
+
+		if(rec.steps >= 0) {
+			JobAction act;
+			job.program = makeJobProgram(job.number, job.maxCPU, scriptSeed);
+			for(job.steps = 0; job.steps < rec.steps; job.steps++)
+				job.program.next(act);
+		}
+	}
+	sortArrivals();
+
+	for(long k = 0; k < header.nodeCount; k++) {
+		Machine *m = machines[k].get();
+		MachineRunRecord &rec = machRecs[k];
+
+		m->clock = rec.clock;
+		m->nextSeq = rec.nextSeq;
+		m->regA = rec.regA;
+		memcpy(m->regP, rec.regP, sizeof(m->regP));
+		m->cpuJob = rec.cpuJob;
+		m->cpuStart = rec.cpuStart;
+		m->quantumLeft = rec.quantumLeft;
+		m->cpuEventSeq = rec.cpuEventSeq;
+		m->diskJob = rec.diskJob;
+		m->cpuBusy = rec.cpuBusy;
+		m->diskBusyTime = rec.diskBusyTime;
+		m->drumBusyTime = rec.drumBusyTime;
+		m->routed = rec.routed;
+		m->terminated = rec.terminated;
+		m->totalResponse = rec.totalResponse;
+		m->output.clear();
+
+		m->jobAtAddr.clear();
+		for(size_t a = 0; a < addrs[k].size(); a += 2)
+			m->jobAtAddr[addrs[k][a]] = addrs[k][a + 1];
+
+		m->events = priority_queue<Event, vector<Event>, greater<Event> >();
+		for(size_t e = 0; e < events[k].size(); e++)
+			m->events.push(events[k][e]);
+	}
+
+	return true;
+}
+
+// True if both files can be read and hold the same bytes
+bool sameFile(const string &a, const string &b)
+{
+	ifstream inA(a.c_str(), ios::binary), inB(b.c_str(), ios::binary);
+
+	if(!inA || !inB)
+		return false;
+
+	string bytesA((istreambuf_iterator<char>(inA)), istreambuf_iterator<char>());
+	string bytesB((istreambuf_iterator<char>(inB)), istreambuf_iterator<char>());
+	return bytesA == bytesB;
+}
+
+/*
+**                      verifyRun(1)
+**
+**    Restores a run that was just saved into the live
+**    state and saves it again next to the first copy.
+**    The run goes on from the restored state, so a
+**    restore that lost anything shows up both in the
+**    comparison and in the rest of the output. Stops the
+**    run if the two copies differ (-V)
+*/
+void verifyRun(const char *fileName)
+{
+	string check = string(fileName) + ".check";
+
+	if(!restoreRun(fileName) || !saveRun(check.c_str())
+	   || !sameFile(fileName, check) || !sameFile(string(fileName) + ".run", check + ".run")) {
+		cerr << "checkpoint of tick " << windowEnd << " in " << fileName << " did not survive a restore" << endl;
+		exit(1);
+	}
+
+	remove(check.c_str());
+	remove((check + ".run").c_str());
+}
+
+/*
+**                      checkpointRun(1)
+**
+**    Saves the run for -C and, with -V, checks that the
+**    save restores to the same state
+*/
+void checkpointRun(const char *fileName)
+{
+	if(!saveRun(fileName)) {
+		cerr << "cannot save the run to " << fileName << " and " << fileName << ".run" << endl;
+		exit(1);
+	}
+
+	if(verifyCheckpoint)
+		verifyRun(fileName);
+	cerr << "run saved at tick " << windowEnd << " to " << fileName << " and " << fileName << ".run" << endl;
+}
+
+/*
+**                      syncMachines(0)
+**
+**    Runs between windows, while no machine is handling
+**    events. Prints the last window's reports, saves the
+**    run if -C asked for it at this point, moves
+**    waiting jobs, then opens the next window that has
+**    something in it and routes the jobs arriving in it,
+**    made up or fed. With a paced feed the window only
+**    opens once the wall clock and the feeder have both
+**    reached its end, so the simulation keeps in step
+**    with the wall clock.
+**    Windows start at multiples of syncWindow, so where
+**    they fall does not depend on the machines' events
+**    and the same run gets the same windows every time
+**	-Output:
+**		false once no machine has anything left to do
+*/
+bool syncMachines()
+{
+	flushOutput();
+
+	if(checkpointFile && windowEnd >= checkpointAt) {
+		checkpointRun(checkpointFile);
+		checkpointFile = NULL;
+	}
+
+	if(migrate)
+		balanceWaitingJobs(windowEnd);
+
+	long next = LONG_MAX;
+	for(size_t k = 0; k < machines.size(); k++)
+		if(!machines[k]->events.empty() && machines[k]->events.top().time < next)
+			next = machines[k]->events.top().time;
+	if(nextArrival < arrivalOrder.size() && jobs[arrivalOrder[nextArrival]].arrival < next)
+		next = jobs[arrivalOrder[nextArrival]].arrival;
+	long fed;
+	if(feeding && nextFedArrival(fed) && fed < next)
+		next = fed > windowEnd ? fed : windowEnd;
+	if(next == LONG_MAX)
+		return false;
+
+	long start = next - next % syncWindow;
+	if(start < windowEnd)
+		start = windowEnd;
+	windowEnd = start + syncWindow;
+
+	routeStale = true;
+	while(nextArrival < arrivalOrder.size() && jobs[arrivalOrder[nextArrival]].arrival < windowEnd)
+		routeJob(arrivalOrder[nextArrival++]);
+	if(feeding) {
+		if(!jobFeedFinished())
+			waitFeedClock(windowEnd);
+		routeFedJobs(start);
+	}
+	return true;
+}
+
+/*
+**                      runSequential(0)
+**
+**    Runs each window on one machine after another
+*/
+void runSequential()
+{
+	while(syncMachines())
+		for(size_t k = 0; k < machines.size(); k++)
+			runWindow(k);
+}
+
+// Completion step of the barrier: the last machine to finish a window runs the sync
+struct SyncStep {
+	void operator ()() noexcept { running = syncMachines(); }
+};
+
+/*
+**                      runMachine(2)
+**
+**    Body of machine k's thread in parallel mode. Runs
+**    a window and waits at the barrier for the others
+*/
+void runMachine(long k, barrier<SyncStep> *sync)
+{
+	while(running) {
+		runWindow(k);
+		sync->arrive_and_wait();
+	}
+}
+
+/*
+**                      runParallel(0)
+**
+**    Gives every machine a thread and runs the windows
+**    between barriers. Machine 0 runs on this thread
+*/
+void runParallel()
+{
+	barrier<SyncStep> sync(machines.size());
+	vector<thread> workers;
+
+	running = syncMachines();
+	for(size_t k = 1; k < machines.size(); k++)
+		workers.push_back(thread(runMachine, (long)k, &sync));
+	runMachine(0, &sync);
+
+	for(size_t k = 0; k < workers.size(); k++)
+		workers[k].join();
+}
+
+int main(int argc, char *argv[])
+{
+	long count = 200;
+	long meanGap = 2000;
+	long nodes = 1;
+	const char *jobFile = NULL;
+	const char *feedFile = NULL;
+	const char *resumeFile = NULL;
+	const char *policy = "ll";
+
+	for(int i = 1; i < argc; i++) {
+		if(!strcmp(argv[i], "-n") && i + 1 < argc)
+			count = atol(argv[++i]);
+		else if(!strcmp(argv[i], "-s") && i + 1 < argc)
+			scriptSeed = strtoul(argv[++i], NULL, 10);
+		else if(!strcmp(argv[i], "-i") && i + 1 < argc && atol(argv[i + 1]) > 0)
+			meanGap = atol(argv[++i]);
+		else if(!strcmp(argv[i], "-j") && i + 1 < argc)
+			jobFile = argv[++i];
+		else if(!strcmp(argv[i], "-f") && i + 1 < argc)
+			feedFile = argv[++i];
+		else if(!strcmp(argv[i], "-t") && i + 1 < argc && atol(argv[i + 1]) > 0)
+			feedPace = atol(argv[++i]);
+		else if(!strcmp(argv[i], "-q"))
+			quiet = true;
+		else if(!strcmp(argv[i], "-p"))
+			parallel = true;
+		else if(!strcmp(argv[i], "-w") && i + 1 < argc && atol(argv[i + 1]) > 0)
+			syncWindow = atol(argv[++i]);
+		else if(!strcmp(argv[i], "-N") && i + 1 < argc && atol(argv[i + 1]) > 0)
+			nodes = atol(argv[++i]);
+		else if(!strcmp(argv[i], "-r") && i + 1 < argc)
+			policy = argv[++i];
+		else if(!strcmp(argv[i], "-m"))
+			migrate = true;
+		else if(!strcmp(argv[i], "-x"))
+			reserveRegions = true;
+		else if(!strcmp(argv[i], "-C") && i + 2 < argc) {
+			checkpointAt = atol(argv[++i]);
+			checkpointFile = argv[++i];
+		}
+		else if(!strcmp(argv[i], "-V"))
+			verifyCheckpoint = true;
+		else if(!strcmp(argv[i], "-R") && i + 1 < argc)
+			resumeFile = argv[++i];
+		else {
+			cerr << "usage: " << argv[0] << " [-n jobs] [-s seed] [-i mean interarrival] [-j jobfile] [-f feedfile] [-t usec per tick] [-q] [-p] [-w window]"
+				 << " [-N nodes] [-r rr|ll|fit|p2c] [-m] [-x] [-C time file] [-V] [-R file]" << endl;
+			return 1;
+		}
+	}
+
+	RouteName *rn;
+	for(rn = routePolicies; rn->name && strcmp(rn->name, policy); rn++);
+	if(!rn->name) {
+		cerr << "unknown routing policy " << policy << endl;
+		return 1;
+	}
+	route = rn->policy;
+	routeState = scriptSeed * 0xBF58476D1CE4E5B9UL + 1;
+
+	if(parallel && nodes == 1 && !resumeFile)
+		cerr << "-p only runs the machines of a cluster (-N) in parallel, a single node runs on one thread" << endl;
+
+	if(feedFile && (checkpointFile || resumeFile)) {
+		cerr << "-C and -R cannot be used with a live feed" << endl;
+		return 1;
+	}
+
+	if(feedFile) {
+		if(!startJobFeed(feedFile, feedPace)) {
+			cerr << "cannot read " << feedFile << endl;
+			return 1;
+		}
+		feeding = true;
+	}
+	else if(resumeFile)
+		; // Jobs come from the saved run
+	else if(jobFile) {
+		if(!loadJobs(jobFile))
+			return 1;
+	}
+	else
+		makeJobs(count, scriptSeed, meanGap);
+
+	cout << endl << endl << "                         OPERATING SYSTEM SIMULATION" << endl << endl << endl << endl;
+	if(resumeFile) {
+		if(!restoreRun(resumeFile)) {
+			cerr << "cannot resume from " << resumeFile << " and " << resumeFile << ".run" << endl;
+			return 1;
+		}
+		for(rn = routePolicies; rn->policy != route; rn++);
+		policy = rn->name;
+	}
+	else {
+		sortArrivals();
+		for(long k = 0; k < nodes; k++) {
+			machines.push_back(newMachine(k));
+			selectMachine(k);
+			startup();
+		}
+	}
+
+	if(parallel)
+		runParallel();
+	else
+		runSequential();
+	stopJobFeed();
+	if(checkpointFile)
+		cerr << "run ended before tick " << checkpointAt << ", nothing saved" << endl;
+
+	long elapsed = 1, terminatedJobs = 0, totalResponse = 0;
+	for(size_t k = 0; k < machines.size(); k++) {
+		if(machines[k]->clock > elapsed)
+			elapsed = machines[k]->clock;
+		terminatedJobs += machines[k]->terminated;
+		totalResponse += machines[k]->totalResponse;
+	}
+
+	cout << endl << endl << " Total jobs :  " << jobs.size() << "       terminated : " << terminatedJobs << endl;
+	if(machines.size() == 1) {
+		Machine *m = machines[0].get();
+		cout << " % utilization CPU : " << m->cpuBusy * 100 / elapsed << "   disk :  " << m->diskBusyTime * 100 / elapsed
+			 << "  drum : " << m->drumBusyTime * 100 / elapsed << endl;
+	}
+	else {
+		for(size_t k = 0; k < machines.size(); k++) {
+			Machine *m = machines[k].get();
+			cout << " node " << k << " :  routed " << m->routed << "   terminated " << m->terminated
+				 << "   throughput/1000 ticks " << m->terminated * 1000.0 / elapsed
+				 << "   mean response " << (m->terminated > 0 ? m->totalResponse / m->terminated : 0) << endl;
+			cout << "     % utilization CPU : " << m->cpuBusy * 100 / elapsed << "   disk :  " << m->diskBusyTime * 100 / elapsed
+				 << "  drum : " << m->drumBusyTime * 100 / elapsed << endl;
+		}
+		cout << " nodes : " << machines.size() << "   routing : " << policy << "   migrations : " << migrations
+			 << "   throughput/1000 ticks : " << terminatedJobs * 1000.0 / elapsed << endl;
+	}
+	if(terminatedJobs > 0)
+		cout << " mean response time : " << totalResponse / terminatedJobs << endl;
+	cout << endl;
+
+	// Coroutine frames and IO lists live in simPool, so free them before it goes away
+	jobs.clear();
+	return 0;
+}
+
+
+/*******     End Scripted Driver     *******/
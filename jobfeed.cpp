@@ -0,0 +1,324 @@
+/*******     Job Feed     *******/
+
+
+#include "os.h"
+
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+
+JobRing jobRing; // Feeder thread -> simulation thread
+thread feeder;
+atomic<bool> feedActive(false); // Set while a feed has been started and not stopped
+atomic<bool> feedDone(false); // Set once the feeder has pushed its last record
+atomic<bool> feedStop(false); // Asks the feeder to quit early
+mutex feedLock; // Guards the waits below: the feeder for an arrival time or ring space, the driver for a job
+condition_variable feedWake; // Notified on every push, take and stop
+chrono::steady_clock::time_point feedStart; // Wall-clock time of tick 0 when the feed is paced
+long feedUsecPerTick = 0;
+
+
+/*
+**			push(1)
+**	-Inputs:
+**		const JobRecord &rec
+**	-Description:
+**		Copies rec into the next free slot and then
+**		publishes it by moving tail. Only the feeder
+**		thread calls this
+**	-Output:
+**		false if the ring is full
+*/
+
+bool JobRing::push(const JobRecord &rec)
+{
+	unsigned long t = tail.load(memory_order_relaxed);
+
+	if(t - head.load(memory_order_acquire) == JOB_RING_SIZE)
+		return false;
+
+	slots[t & (JOB_RING_SIZE - 1)] = rec;
+	tail.store(t + 1, memory_order_release);
+	return true;
+}
+
+
+/*
+**			peek(1)
+**	-Inputs:
+**		JobRecord &rec
+**	-Description:
+**		Copies the oldest record into rec. The slot stays
+**		owned by the consumer until pop() is called. Only
+**		the simulation thread calls this
+**	-Output:
+**		false if the ring is empty
+*/
+
+bool JobRing::peek(JobRecord &rec)
+{
+	unsigned long h = head.load(memory_order_relaxed);
+
+	if(h == tail.load(memory_order_acquire))
+		return false;
+
+	rec = slots[h & (JOB_RING_SIZE - 1)];
+	return true;
+}
+
+
+/*
+**			pop(0)
+**	-Description:
+**		Hands the oldest slot back to the producer
+*/
+
+void JobRing::pop()
+{
+	head.store(head.load(memory_order_relaxed) + 1, memory_order_release);
+}
+
+
+/*
+**			feedJobs(2)
+**	-Inputs:
+**		ifstream in, long usecPerTick
+**	-Description:
+**		Body of the feeder thread. Reads one job per line
+**		(job number, priority, size, max cpu time, arrival
+**		time) from a file, a FIFO or any other stream
+**		startJobFeed(2) opened. Input that is not a job
+**		ends the feed with a message. With usecPerTick > 0 each job is held
+**		back until its arrival time in wall-clock terms,
+**		unless stopJobFeed() cuts the wait short. When the
+**		ring is full the feeder blocks until the driver
+**		takes a job, the driver never waits for ring space
+**	-Output:
+**		none
+*/
+
+void feedJobs(ifstream in, long usecPerTick)
+{
+	JobRecord rec;
+
+	while(!feedStop.load(memory_order_relaxed)
+		  && in >> rec.jobNumber >> rec.priority >> rec.jobSize >> rec.maxCPUTime >> rec.timeOfArrival) {
+		unique_lock<mutex> lk(feedLock);
+
+		if(usecPerTick > 0 && feedWake.wait_until(lk, feedStart + chrono::microseconds(rec.timeOfArrival * usecPerTick),
+												  [] { return feedStop.load(memory_order_relaxed); }))
+			break;
+
+		// takeFedJob() notifies once it has made room
+		feedWake.wait(lk, [&] { return feedStop.load(memory_order_relaxed) || jobRing.push(rec); });
+		if(feedStop.load(memory_order_relaxed))
+			break;
+		lk.unlock();
+		feedWake.notify_all();
+	}
+
+	if(!feedStop.load(memory_order_relaxed) && !in.eof())
+		cerr << "feed: stopped at a line that is not a job (job number, priority, size, max cpu time, arrival time)" << endl;
+
+	{
+		lock_guard<mutex> lk(feedLock);
+		feedDone.store(true, memory_order_release);
+	}
+	feedWake.notify_all();
+}
+
+
+/*
+**			startJobFeed(2)
+**	-Inputs:
+**		const char *fileName, long usecPerTick
+**	-Description:
+**		Starts the feeder thread. usecPerTick is how many
+**		microseconds of wall-clock time one clock tick of
+**		the simulation takes, 0 pushes jobs as fast as
+**		the ring accepts them
+**	-Output:
+**		false if a feed is already running or the file
+**		cannot be opened
+*/
+
+bool startJobFeed(const char *fileName, long usecPerTick)
+{
+	if(feedActive.load())
+		return false;
+
+	// Opened here so the caller hears about a bad path. A FIFO blocks until its writer opens it
+	ifstream in(fileName);
+	if(!in)
+		return false;
+
+	feedStop.store(false);
+	feedDone.store(false);
+	feedStart = chrono::steady_clock::now();
+	feedUsecPerTick = usecPerTick;
+	feeder = thread(feedJobs, move(in), usecPerTick);
+	feedActive.store(true, memory_order_release);
+	return true;
+}
+
+
+/*
+**			stopJobFeed(0)
+**	-Description:
+**		Asks the feeder to quit, waits for it and throws
+**		away whatever is still in the ring
+*/
+
+void stopJobFeed()
+{
+	if(!feedActive.load())
+		return;
+
+	{
+		lock_guard<mutex> lk(feedLock);
+		feedStop.store(true);
+	}
+	feedWake.notify_all();
+	feeder.join();
+	feedActive.store(false);
+
+	while(!jobRing.empty())
+		jobRing.pop();
+}
+
+
+/*
+**			takeFedJob(2)
+**	-Inputs:
+**		long before, JobRecord &rec
+**	-Description:
+**		Moves the oldest job in the ring into rec if it
+**		arrives before the given time. The driver raises
+**		Crint(2) for it at its arrival time, like for any
+**		other job, so fed jobs are never admitted from
+**		inside another interrupt. Returns at once when
+**		nothing is ready
+**	-Output:
+**		true if a job was taken
+*/
+
+bool takeFedJob(long before, JobRecord &rec)
+{
+	if(!feedActive.load(memory_order_acquire) || !jobRing.peek(rec) || rec.timeOfArrival >= before)
+		return false;
+
+	jobRing.pop();
+	{
+		lock_guard<mutex> lk(feedLock); // A feeder blocked on a full ring checks for room under the lock
+	}
+	feedWake.notify_all();
+	return true;
+}
+
+
+/*
+**			nextFeedArrival(1)
+**	-Inputs:
+**		long &arrival
+**	-Description:
+**		Lets a driver find out when the next fed job is
+**		due so it can raise an interrupt at that time
+**	-Output:
+**		true if a job is waiting in the ring
+*/
+
+bool nextFeedArrival(long &arrival)
+{
+	JobRecord rec;
+
+	if(!feedActive.load(memory_order_acquire) || !jobRing.peek(rec))
+		return false;
+
+	arrival = rec.timeOfArrival;
+	return true;
+}
+
+
+/*
+**			waitFeedJob(1)
+**	-Inputs:
+**		long &arrival
+**	-Description:
+**		Blocks, without spinning, until a job is in the
+**		ring or the feeder has read all of its input
+**	-Output:
+**		true and the job's arrival time if a job came in,
+**		false once the feed is finished
+*/
+
+bool waitFeedJob(long &arrival)
+{
+	unique_lock<mutex> lk(feedLock);
+
+	feedWake.wait(lk, [] { return !feedActive.load(memory_order_acquire) || !jobRing.empty()
+								  || feedDone.load(memory_order_acquire); });
+	lk.unlock();
+	return nextFeedArrival(arrival);
+}
+
+
+/*
+**			feedClock(0)
+**	-Description:
+**		Lets a driver keep its clock in step with a paced
+**		feed: the tick the wall clock has reached since the
+**		feed started
+**	-Output:
+**		the tick, 0 if the feed is not paced
+*/
+
+long feedClock()
+{
+	if(!feedActive.load(memory_order_acquire) || feedUsecPerTick <= 0)
+		return 0;
+
+	chrono::microseconds since = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - feedStart);
+	return since.count() / feedUsecPerTick;
+}
+
+
+/*
+**			waitFeedClock(1)
+**	-Inputs:
+**		long tick
+**	-Description:
+**		Sleeps until the wall clock reaches tick of a paced
+**		feed. A job the feeder pushes after that arrives
+**		late. A feed that is not paced returns at once
+**	-Output:
+**		none
+*/
+
+void waitFeedClock(long tick)
+{
+	if(!feedActive.load(memory_order_acquire) || feedUsecPerTick <= 0)
+		return;
+
+	this_thread::sleep_until(feedStart + chrono::microseconds(tick * feedUsecPerTick));
+}
+
+
+/*
+**			jobFeedFinished(0)
+**	-Output:
+**		true if no feed is running, or the feeder has
+**		read its whole input and the ring is drained
+*/
+
+bool jobFeedFinished()
+{
+	if(!feedActive.load(memory_order_acquire))
+		return true;
+
+	return feedDone.load(memory_order_acquire) && jobRing.empty();
+}
+
+
+/*******     End Job Feed     *******/
@@ -0,0 +1,141 @@
+/*******     Job Scripts     *******/
+
+
+#include "os.h"
+
+/*
+**	Each profile below is a coroutine. Its locals (the work
+**	left and a one-word random state) live in the coroutine
+**	frame, so a job that is waiting for the CPU or the disk
+**	holds nothing else
+*/
+
+
+/*
+**			randomBetween(3)
+**	-Inputs:
+**		unsigned long &state, long lo, long hi
+**	-Description:
+**		xorshift64* step, small enough to keep inside
+**		a coroutine frame
+**	-Output:
+**		a number in [lo, hi]
+*/
+
+long randomBetween(unsigned long &state, long lo, long hi)
+{
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return lo + (long)((state * 2685821657736338717UL) % (unsigned long)(hi - lo + 1));
+}
+
+
+/*
+**			cpuBoundJob(2)
+**	-Description:
+**		Long CPU bursts with an occasional IO request.
+**		Waits for its IO before terminating
+*/
+
+JobProgram cpuBoundJob(long work, unsigned long state)
+{
+	bool didIO = false;
+
+	while(work > 0) {
+		long burst = randomBetween(state, 200, 3000);
+		if(burst > work)
+			burst = work;
+		co_yield cpuBurst(burst);
+		work -= burst;
+
+		if(randomBetween(state, 1, 4) == 1) {
+			co_yield ioRequest(randomBetween(state, 20, 80));
+			didIO = true;
+		}
+	}
+
+	if(didIO)
+		co_yield blockRequest();
+}
+
+
+/*
+**			ioBoundJob(2)
+**	-Description:
+**		Short CPU bursts, each followed by an IO request.
+**		Blocks for its IO after every few requests
+*/
+
+JobProgram ioBoundJob(long work, unsigned long state)
+{
+	long requests = 0;
+
+	while(work > 0) {
+		long burst = randomBetween(state, 2, 30);
+		if(burst > work)
+			burst = work;
+		co_yield cpuBurst(burst);
+		work -= burst;
+
+		co_yield ioRequest(randomBetween(state, 10, 40));
+		if(++requests % 3 == 0)
+			co_yield blockRequest();
+	}
+}
+
+
+/*
+**			interactiveJob(2)
+**	-Description:
+**		Small bursts where every IO is waited on right
+**		away, like a job talking to a terminal
+*/
+
+JobProgram interactiveJob(long work, unsigned long state)
+{
+	while(work > 0) {
+		long burst = randomBetween(state, 5, 100);
+		if(burst > work)
+			burst = work;
+		co_yield cpuBurst(burst);
+		work -= burst;
+
+		co_yield ioRequest(randomBetween(state, 5, 30));
+		co_yield blockRequest();
+	}
+}
+
+
+/*
+**			makeJobProgram(3)
+**	-Inputs:
+**		long jobNumber, long maxCPUTime, unsigned long seed
+**	-Description:
+**		Picks one of the profiles above for a job and how
+**		much CPU time it will ask for. About one job in
+**		eight asks for more than its max cpu time, so it
+**		is terminated abnormally
+**	-Output:
+**		the job's program, suspended before its first action
+*/
+
+JobProgram makeJobProgram(long jobNumber, long maxCPUTime, unsigned long seed)
+{
+	unsigned long state = seed * 0x9E3779B97F4A7C15UL + jobNumber * 0xBF58476D1CE4E5B9UL + 1;
+	long work;
+
+	if(randomBetween(state, 1, 8) == 1)
+		work = maxCPUTime + randomBetween(state, 1, 100);
+	else
+		work = randomBetween(state, 1, maxCPUTime);
+
+	switch(randomBetween(state, 1, 3)) {
+		case 1:		return cpuBoundJob(work, state);
+		case 2:		return ioBoundJob(work, state);
+		default:	return interactiveJob(work, state);
+	}
+}
+
+
+/*******     End Job Scripts     *******/
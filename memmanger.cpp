@@ -17,7 +17,8 @@
 **		none
 */
 
-MemoryManager::MemoryManager() 
+MemoryManager::MemoryManager():
+scratch(scratchBuf, SCRATCH_BYTES, &pool), fsTable(&pool)
 {
 	pair<long,long> firstEntry(100,0);
 	fsTable.insert(firstEntry);
@@ -59,7 +60,7 @@ void MemoryManager::insertInTable(pair<long,long> newEntry)
 pair<long, long> MemoryManager::findSpace(long jobSize)
 {
 	pair<long,long> temp;
-	multimap<long,long,less<long> >::iterator it;
+	FSTable::iterator it;
 	
 	if(fsTable.empty()) {
 		return pair<long, long>(0,0);   //--->Default constructor always has a value within the map, would it ever be empty?
@@ -84,16 +85,20 @@ pair<long, long> MemoryManager::findSpace(long jobSize)
 **	-Description:
 **		This function will combine fragments that
 **		are adjacent to each other in order to reduce
-**		fragmentation within the free space table
+**		fragmentation within the free space table.
+**		Its temporaries live in the scratch arena,
+**		which is emptied at the start of every call
 **	-Output:
 **		none
 */
 
 void MemoryManager::defragment()
 {
-	multimap<long,long,less<long> > temp;
-	multimap<long,long,less<long> >::iterator it;
-	list<long> numStr;
+	scratch.release();
+	
+	FSTable temp(&scratch);
+	FSTable::iterator it;
+	pmr::list<long> numStr(&scratch);
 	long size = 0, addr = 0, newSize = 0;
 
 	for(it = fsTable.begin(); it != fsTable.end(); it++)
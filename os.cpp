@@ -15,19 +15,16 @@
 #define tro 	10
 #define svc		11
 
+//Memory Resources
+pmr::synchronized_pool_resource simPool; // Simulation-wide allocations (job scripts), shared by every machine thread
+
 //Global Data Structures
-MemoryManager memManager; // Representation of FST
-list<PCB> cpuReadyQueue; // List of jobs that are capable of running on CPU & other operations
-list<PCB> ioQueue; // Queue of jobs asking for IO (Each job can have more than one instance)
-list<PCB>::iterator runningJob; // Pointer to job that is currently running
-queue<PCB> shortTermSch; // Jobs that found space in memory, but have not been swapped by the drum yet
-multimap<long, PCB, less<long> > longTermSch; // LTS that sorts jobs by maxCPUTime when they do not find space in memory
+Node firstNode; // The only machine unless a driver sets up more
+thread_local Node *curNode = &firstNode; // Each machine thread points it at its own Node
 
 //Global Variables
 long TIME_SLICE; // Time quantum given to a job when it's dispatched to CPU
-
-bool drumBusy; // Semaphore to check if drum is in use (Swapping a job in core)
-bool diskBusy; // Semaphore to check if disk is in use (A job is currently doing IO)
+bool reserveRegions = false; // Lets bookKeeping reserve regions of terminating jobs for LTS jobs (off unless a driver asks)
 
 //Prototypes
 void siodisk(long jobNum);
@@ -36,6 +33,9 @@ void ontrace();
 void offtrace();
 void dispatcher(long &, long *);
 void longTermScheduler(); // Loads a job into memory. Jobs located here did not find space in memory when they were Crinted in
+void reserveRegion(PCB &job); // Picks the LTS job that gets a terminating job's region
+void releaseReservation(long addr); // Loads the job reserved for a region that was just freed
+void startSwapIn(); // Starts the drum on the front of the STS if it is idle
 void bookKeeping(long &a, long p[]); // Checks the job status. Terminates, unblocks, etc.
 long assignCorrectTimeQuantum(); // Assigns time quantum (Either TIME_SLICE or remaining CPU time)
 void moveJobPtr(); // Moves job pointer forward in cpuReadyQueue
@@ -53,14 +53,24 @@ void testFunc(int); // Debugging function
 **			By Rakib Hasan, Jeremy Levine, Michael Figueroa & Frank Gassoso        **
 ************************************************************************************/
 
+/*
+**     Sets up an empty machine. Its queues take their
+**     nodes from the machine's own pool
+*/
+Node::Node():
+interruptScratch(interruptScratchBuf, SCRATCH_BYTES, &pool), cpuReadyQueue(&pool), ioQueue(&pool),
+shortTermSch(&pool), longTermSch(&pool), reservations(&pool), reserveMisses(&pool), ltsGeneration(0),
+drumBusy(false), diskBusy(false)
+{}
+
 /*
 **     This function initializes values
 */
 void startup()
 {
     TIME_SLICE = 400;
-    drumBusy = false;
-    diskBusy = false;
+    curNode->drumBusy = false;
+    curNode->diskBusy = false;
     offtrace();
 }
 
@@ -80,38 +90,23 @@ void startup()
 void Crint(long &a, long p[])
 {
     PCB newJob(p[job_number],p[job_priority],p[job_size],p[time_remaining],p[time_arrival]);
-    pair<long, long> freeSpace;
 	
-    // Looks for free-space in memory
-    freeSpace = memManager.findSpace(newJob[job_size]);
-	
-    if(freeSpace.first != 0) {
-		// If found push onto short term scheduler
-		newJob.setJobAddr(freeSpace.second);
-		shortTermSch.push(newJob);
-		// Insert excess space
-		memManager.insertInTable(pair<long,long>(freeSpace.first - newJob[job_size],
-		freeSpace.second + newJob[job_size]));
-		memManager.defragment();
-    }
-	else
-		// If not put onto LTS
-        longTermSch.insert(pair<long, PCB>(newJob[time_remaining], newJob));
+    admitJob(newJob);
 		
-    if(!shortTermSch.empty()&&!drumBusy) {   
+    if(!curNode->shortTermSch.empty()&&!curNode->drumBusy) {   
 		// Call siodrum for jobs on shorttermsch
-        PCB temp(shortTermSch.front());
+        PCB temp(curNode->shortTermSch.front());
         siodrum(temp[job_number], temp[job_size], temp[core_addr], 0);
-        drumBusy = true;
+        curNode->drumBusy = true;
     }
 	
-    if(!ioQueue.empty()&&!diskBusy) {   
+    if(!curNode->ioQueue.empty()&&!curNode->diskBusy) {   
 		// Call siodisk for jobs on IOQueue
-        siodisk(ioQueue.front()[job_number]);
-        diskBusy = true;
+        siodisk(curNode->ioQueue.front()[job_number]);
+        curNode->diskBusy = true;
     }
 	
-    if(!cpuReadyQueue.empty()) {
+    if(!curNode->cpuReadyQueue.empty()) {
         bookKeeping(a,p);
         dispatcher(a,p);
     } 
@@ -120,49 +115,84 @@ void Crint(long &a, long p[])
     //testFunc(crint);
 }
 
+/*
+**                        admitJob(1)
+**           by Frank Gassoso and Jeremy Levine
+**
+**    Looks for space in the memory table for a new job.
+**    If it finds space the job is put onto the short
+**    term scheduler and the excess space goes back into
+**    the memory table, otherwise the job is stored in
+**    the long term scheduler. Used by Crint(2), which also
+**    raises it for jobs that come from the live feed.
+*/
+void admitJob(PCB &newJob)
+{
+    pair<long, long> freeSpace;
+	
+    // Looks for free-space in memory
+    freeSpace = curNode->memManager.findSpace(newJob[job_size]);
+	
+    if(freeSpace.first != 0) {
+		// If found push onto short term scheduler
+		newJob.setJobAddr(freeSpace.second);
+		curNode->shortTermSch.push(newJob);
+		// Insert excess space
+		curNode->memManager.insertInTable(pair<long,long>(freeSpace.first - newJob[job_size],
+		freeSpace.second + newJob[job_size]));
+		curNode->memManager.defragment();
+    }
+	else {
+		// If not put onto LTS
+        curNode->longTermSch.insert(pair<long, PCB>(newJob[time_remaining], newJob));
+        curNode->ltsGeneration++;
+    }
+}
+
 /*
 **                         Drmint(2)
 **            by Frank Gassoso and Jeremy Levine
 **
 **    This function gets called when after siodrum is called
 **    for a program. It takes the front value of the short
-**    term scheduler and pushing it onto cpuReadyQueue. If
+**    term scheduler and pushing it onto cpuReadyQueue, which
+**    frees the drum for the next job on the STS. If
 **    the cpuReadyQueue was empty before puting a new job
 **    on the cpuReadyQueue, then it sets the running job pointer
 **    rqIt to the beginning of the cpuReadyQueue
 */
 void Drmint(long &a, long p[])
 {
-	bool startRRFromBeginning = cpuReadyQueue.empty();
-    cpuReadyQueue.push_back(shortTermSch.front());
-    shortTermSch.pop();
+	bool startRRFromBeginning = curNode->cpuReadyQueue.empty();
+    curNode->cpuReadyQueue.push_back(curNode->shortTermSch.front());
+    curNode->shortTermSch.pop();
+    curNode->drumBusy = false; // The swap that raised Drmint is done
 	
 	// If cpuReadyQueue was empty before Drmint(2) called
     //then set runningJob to beginning of readyQueue
     if(startRRFromBeginning)
-		runningJob = cpuReadyQueue.begin();
+		curNode->runningJob = curNode->cpuReadyQueue.begin();
 		
 	// If IOQueue not empty do IO for job in front of list
-    if(!ioQueue.empty() && !diskBusy) {
-          siodisk(ioQueue.front()[job_number]);
-          diskBusy = true;
+    if(!curNode->ioQueue.empty() && !curNode->diskBusy) {
+          siodisk(curNode->ioQueue.front()[job_number]);
+          curNode->diskBusy = true;
     }
 	
-    if(!shortTermSch.empty() && !drumBusy) {   
+    if(!curNode->shortTermSch.empty() && !curNode->drumBusy) {   
 		// Call siodrum for jobs on STS
-        PCB temp(shortTermSch.front());
+        PCB temp(curNode->shortTermSch.front());
         siodrum(temp[job_number], temp[job_size], temp[core_addr], 0);
-        drumBusy = true;
+        curNode->drumBusy = true;
     }
 	
-    if(!cpuReadyQueue.empty()) {
+    if(!curNode->cpuReadyQueue.empty()) {
         bookKeeping(a,p);
         dispatcher(a,p);
     }
 	else
 		a = 1;
 		
-    drumBusy = false;
     //testFunc(drmint);
 }
 
@@ -176,30 +206,30 @@ void Drmint(long &a, long p[])
 */
 void Dskint(long &a, long p[])
 {
-    list<PCB>::iterator it;
+    PCBList::iterator it;
 	
-    for(it = cpuReadyQueue.begin(); it != cpuReadyQueue.end(); it++) {
-		if(*it == ioQueue.front()) {
+    for(it = curNode->cpuReadyQueue.begin(); it != curNode->cpuReadyQueue.end(); it++) {
+		if(*it == curNode->ioQueue.front()) {
             it->decIOcnt();
 			break;
         }
     }
 	// Pop IO Queue (Front is job that just finished doing IO)
-    ioQueue.pop_front();
+    curNode->ioQueue.pop_front();
 	
-    if(!cpuReadyQueue.empty()) {
+    if(!curNode->cpuReadyQueue.empty()) {
         bookKeeping(a,p);
         dispatcher(a,p);
     }
 	else
 		a = 1;
 		
-    diskBusy = false; // Set diskBusy to false. Dskint is called when the disk finishes its current IO
+    curNode->diskBusy = false; // Set diskBusy to false. Dskint is called when the disk finishes its current IO
 	
-    if(!ioQueue.empty() && !diskBusy) {   
+    if(!curNode->ioQueue.empty() && !curNode->diskBusy) {   
 		// Call siodisk for jobs on ioqueue
-        siodisk(ioQueue.front()[job_number]);
-        diskBusy = true;
+        siodisk(curNode->ioQueue.front()[job_number]);
+        curNode->diskBusy = true;
     }
 	
     //testFunc(dskint);
@@ -220,29 +250,29 @@ void Dskint(long &a, long p[])
 */
 void Tro(long &a, long p[5])
 {
-    runningJob->setJobRunning(false);
-    runningJob->decrementTimeRemaining(p[5]-runningJob->getStartingTimeExecution());
+    curNode->runningJob->setJobRunning(false);
+    curNode->runningJob->decrementTimeRemaining(p[5]-curNode->runningJob->getStartingTimeExecution());
 	
-    if(runningJob->getTimeRemaining() == 0)   
+    if(curNode->runningJob->getTimeRemaining() == 0)   
 		// If job has no time remaining on cpu then terminate
-        runningJob->setTerminated(true);
+        curNode->runningJob->setTerminated(true);
 		
     moveJobPtr(); // Move job pointer to next job in cpuReadyQueue
 	
-    if(!shortTermSch.empty() && !drumBusy) {
+    if(!curNode->shortTermSch.empty() && !curNode->drumBusy) {
         // Call siodrum for jobs on STS
-        PCB temp(shortTermSch.front());
+        PCB temp(curNode->shortTermSch.front());
         siodrum(temp[job_number], temp[job_size], temp[core_addr], 0);
-        drumBusy = true;
+        curNode->drumBusy = true;
     }
 	
-    if(!ioQueue.empty() && !diskBusy) {   
+    if(!curNode->ioQueue.empty() && !curNode->diskBusy) {   
 		// Call siodisk for jobs on ioqueue
-        siodisk(ioQueue.front()[job_number]);
-        diskBusy = true;
+        siodisk(curNode->ioQueue.front()[job_number]);
+        curNode->diskBusy = true;
     }
 
-    if(!cpuReadyQueue.empty()) {
+    if(!curNode->cpuReadyQueue.empty()) {
         bookKeeping(a,p);
         dispatcher(a,p);
     }
@@ -270,42 +300,42 @@ void Svc(long &a, long p[])
     switch(a) {
         case 5:
             // Terminate job
-            runningJob->setTerminated(true);
-            runningJob->setJobRunning(false);
-            runningJob->decrementTimeRemaining(p[5]-runningJob->getStartingTimeExecution());
+            curNode->runningJob->setTerminated(true);
+            curNode->runningJob->setJobRunning(false);
+            curNode->runningJob->decrementTimeRemaining(p[5]-curNode->runningJob->getStartingTimeExecution());
             moveJobPtr();
 			break;
         case 6:
             // Put job on ioQueue
-            runningJob->incIOcnt();
-            ioQueue.push_back(*runningJob);
+            curNode->runningJob->incIOcnt();
+            curNode->ioQueue.push_back(*curNode->runningJob);
 			break;
         case 7:
             // Block jobs if it has at least one pending IO
-            if(runningJob->isPendingIO()) {
-                runningJob->setBlocked(true);
+            if(curNode->runningJob->isPendingIO()) {
+                curNode->runningJob->setBlocked(true);
               //  runningJob->setStartingTimeBlocked(p[5]);
-                runningJob->setJobRunning(false);
-                runningJob->decrementTimeRemaining(p[5]-runningJob->getStartingTimeExecution());
+                curNode->runningJob->setJobRunning(false);
+                curNode->runningJob->decrementTimeRemaining(p[5]-curNode->runningJob->getStartingTimeExecution());
                 moveJobPtr();
             }
 			break;
     }
 	
-    if(!shortTermSch.empty() && !drumBusy) {
+    if(!curNode->shortTermSch.empty() && !curNode->drumBusy) {
         // Call siodrum for jobs on shorttermsch
-        PCB temp(shortTermSch.front());
+        PCB temp(curNode->shortTermSch.front());
         siodrum(temp[job_number], temp[job_size], temp[core_addr], 0);
-        drumBusy = true;
+        curNode->drumBusy = true;
     }
 	
-    if(!ioQueue.empty() && !diskBusy) {   
+    if(!curNode->ioQueue.empty() && !curNode->diskBusy) {   
 		// Call siodisk for jobs on ioqueue
-        siodisk(ioQueue.front()[job_number]);
-        diskBusy = true;
+        siodisk(curNode->ioQueue.front()[job_number]);
+        curNode->diskBusy = true;
     }
 
-    if(!cpuReadyQueue.empty()) {
+    if(!curNode->cpuReadyQueue.empty()) {
         bookKeeping(a,p);
         dispatcher(a,p);
     }
@@ -331,9 +361,9 @@ void Svc(long &a, long p[])
 void dispatcher(long &a, long p[])
 {
     // Put CPU in running mode
-    int rqLen = cpuReadyQueue.size();
+    int rqLen = curNode->cpuReadyQueue.size();
     while(rqLen > 0) {
-		if(runningJob->isBlocked() || runningJob->isTerminated()) {
+		if(curNode->runningJob->isBlocked() || curNode->runningJob->isTerminated()) {
 			moveJobPtr();
 			rqLen--;
 		}
@@ -347,13 +377,13 @@ void dispatcher(long &a, long p[])
     else {
         a = 2;
         // Store correct values in register
-        p[2] = runningJob->getJobAddress();
-        p[3] = runningJob->getJobSize();
+        p[2] = curNode->runningJob->getJobAddress();
+        p[3] = curNode->runningJob->getJobSize();
         p[4] = assignCorrectTimeQuantum();
 		
         // Store starting time of process somewhere
-        runningJob->setStartingTimeExecution(p[5]);
-        runningJob->setJobRunning(true);
+        curNode->runningJob->setStartingTimeExecution(p[5]);
+        curNode->runningJob->setJobRunning(true);
     }
 }
 
@@ -366,17 +396,23 @@ void dispatcher(long &a, long p[])
 **    cpuReadyQueue, if there is pending IO then it sets the
 **    pendingIO bit to true, if the terminate bit is set and
 **    pendingIO bit is set to false then it stores the job space
-**    into the free space table, if it's  blocked bit is set to
+**    into the free space table and swaps in the jobs that get
+**    that space right away. A terminated job that is still
+**    waiting on a few IOs has its region reserved for a job on
+**    the LTS instead. If it's  blocked bit is set to
 **    true and the pendingIO bit is false then it unblocks the job,
 **    if the jobRunning bit is set to true then it decrements the
 **    the time since it started execution from it's time remaining
 */
 void bookKeeping(long &a, long p[])
 {
-    queue<list<PCB>::iterator > eraseQ;
-    list<PCB>::iterator it;
+    // Temporaries below live in interruptScratch, which is reset here because
+    // bookKeeping runs at most once per interrupt
+    curNode->interruptScratch.release();
+    queue<PCBList::iterator, pmr::deque<PCBList::iterator> > eraseQ(&curNode->interruptScratch);
+    PCBList::iterator it;
 	
-    for(it = cpuReadyQueue.begin(); it != cpuReadyQueue.end(); it++) {   //set pending io to true if io count is greater then 0
+    for(it = curNode->cpuReadyQueue.begin(); it != curNode->cpuReadyQueue.end(); it++) {   //set pending io to true if io count is greater then 0
         if(it->getIOcnt() > 0)
 			it->setPendingIO(true);
         else
@@ -384,16 +420,20 @@ void bookKeeping(long &a, long p[])
 			
 		// If a job is terminated and has no pending IO then add mem to free space remove from RQ
         if(it->isTerminated() && !it->isPendingIO()) {
-            memManager.insertInTable(pair<long,long>((*it)[job_size], (*it)[core_addr]));
-            memManager.defragment();
+            curNode->memManager.insertInTable(pair<long,long>((*it)[job_size], (*it)[core_addr]));
+            curNode->memManager.defragment();
             eraseQ.push(it);
 			
-            if(*runningJob == *it)
+            if(*curNode->runningJob == *it)
                 moveJobPtr();
 				
-            if(!longTermSch.empty())
+            releaseReservation((*it)[core_addr]);
+            if(!curNode->longTermSch.empty())
 				longTermScheduler();
+            startSwapIn();
         }
+        else if(reserveRegions && it->isTerminated() && it->getIOcnt() <= RESERVE_IO_LIMIT)
+            reserveRegion(*it);
 		
 		// If a job is blocked and not pending io then unblock the job
         if(it->isBlocked() && !it->isPendingIO())
@@ -404,13 +444,13 @@ void bookKeeping(long &a, long p[])
     }
 	
     while(!eraseQ.empty()) {
-        cpuReadyQueue.erase(eraseQ.front());
+        curNode->cpuReadyQueue.erase(eraseQ.front());
         eraseQ.pop();
     }
 	
     // Update the timeRemaining variable for running job
     /** if(runningJob->isRunning())
-		runningJob->decrementTimeRemaining(p[5]-runningJob->getStartingTimeExecution());
+		curNode->runningJob->decrementTimeRemaining(p[5]-curNode->runningJob->getStartingTimeExecution());
 	**/
 }
 
@@ -426,8 +466,8 @@ long assignCorrectTimeQuantum()
 {
     // If the timeRemaining is less than TIME_SLICE
 	// return the difference. Else, return TIME_SLICE
-    if((runningJob->getTimeRemaining() - TIME_SLICE) < 0)
-        return runningJob->getTimeRemaining();
+    if((curNode->runningJob->getTimeRemaining() - TIME_SLICE) < 0)
+        return curNode->runningJob->getTimeRemaining();
 	else
         return TIME_SLICE;
 }
@@ -444,40 +484,193 @@ long assignCorrectTimeQuantum()
 */
 void longTermScheduler()
 {
-	multimap< long, PCB, greater<long> >::iterator it;
-	queue< multimap< long, PCB, greater<long> >::iterator > eraseits;
+	LTSMap::iterator it;
+	queue<LTSMap::iterator, pmr::deque<LTSMap::iterator> > eraseits(&curNode->interruptScratch);
 	pair<long,long> freeSpace;
 	
-	for(it = longTermSch.begin(); it != longTermSch.end(); it++) {   // Find space for a job located in LTS
-     	freeSpace = memManager.findSpace((it->second)[job_size]);
+	for(it = curNode->longTermSch.begin(); it != curNode->longTermSch.end(); it++) {   // Find space for a job located in LTS
+     	freeSpace = curNode->memManager.findSpace((it->second)[job_size]);
     		if(freeSpace.first != 0) {   
 				// If space is found, push to STS
                 (it->second).setJobAddr(freeSpace.second);
-                shortTermSch.push((it->second));
+                curNode->shortTermSch.push((it->second));
 				
-                memManager.insertInTable(pair<long,long>(freeSpace.first - (it->second)[job_size],
+                curNode->memManager.insertInTable(pair<long,long>(freeSpace.first - (it->second)[job_size],
 										freeSpace.second + (it->second)[job_size]));
 				
-                memManager.defragment();
+                curNode->memManager.defragment();
+                dropReservation((it->second)[job_number]);
                 eraseits.push(it);
             }
 	}
 	
 	if(!eraseits.empty())
 		while(!eraseits.empty()) {
-            longTermSch.erase(eraseits.front());
+            curNode->longTermSch.erase(eraseits.front());
             eraseits.pop();
         }
 }
 
+/*
+**                      reserveRegion(1)
+**
+**    Called for a terminated job that only waits on a few
+**    IOs. Picks the first job in LTS order that fits in
+**    its region and is not reserved elsewhere, so that job
+**    is loaded the moment the region is freed. A region no
+**    job could be found for is not looked at again until
+**    the LTS gains a job
+*/
+void reserveRegion(PCB &job)
+{
+    if(curNode->reservations.count(job[core_addr]))
+        return;
+		
+    ReservationMap::iterator miss = curNode->reserveMisses.find(job[core_addr]);
+    if(miss != curNode->reserveMisses.end() && miss->second == curNode->ltsGeneration)
+        return;
+	
+    LTSMap::iterator it;
+    ReservationMap::iterator res;
+	
+    for(it = curNode->longTermSch.begin(); it != curNode->longTermSch.end(); it++) {
+        if((it->second)[job_size] > job[job_size])
+            continue;
+			
+        for(res = curNode->reservations.begin(); res != curNode->reservations.end(); res++)
+            if(res->second == (it->second)[job_number])
+                break;
+				
+        if(res == curNode->reservations.end()) {
+            curNode->reservations[job[core_addr]] = (it->second)[job_number];
+            return;
+        }
+    }
+	
+    curNode->reserveMisses[job[core_addr]] = curNode->ltsGeneration;
+}
+
+/*
+**                      dropReservation(1)
+**
+**    Called when a job leaves the LTS some other way than
+**    through its reservation, so its region can be
+**    reserved for another job
+*/
+void dropReservation(long jobNum)
+{
+    ReservationMap::iterator res;
+	
+    for(res = curNode->reservations.begin(); res != curNode->reservations.end(); res++) {
+        if(res->second == jobNum) {
+            curNode->reservations.erase(res);
+            return;
+        }
+    }
+}
+
+/*
+**                      releaseReservation(1)
+**
+**    Called once the region at addr is back in the free
+**    space table. Moves the job reserved for it from the
+**    LTS to the STS ahead of anything longTermScheduler
+**    picks. Nothing happens if the job already left the LTS
+*/
+void releaseReservation(long addr)
+{
+    ReservationMap::iterator res = curNode->reservations.find(addr);
+	
+    curNode->reserveMisses.erase(addr);
+    if(res == curNode->reservations.end())
+        return;
+		
+    long jobNum = res->second;
+    curNode->reservations.erase(res);
+	
+    LTSMap::iterator it;
+    for(it = curNode->longTermSch.begin(); it != curNode->longTermSch.end(); it++) {
+        if((it->second)[job_number] == jobNum) {
+            pair<long,long> freeSpace = curNode->memManager.findSpace((it->second)[job_size]);
+			
+            if(freeSpace.first != 0) {
+                (it->second).setJobAddr(freeSpace.second);
+                curNode->shortTermSch.push(it->second);
+                curNode->memManager.insertInTable(pair<long,long>(freeSpace.first - (it->second)[job_size],
+                                        freeSpace.second + (it->second)[job_size]));
+                curNode->memManager.defragment();
+                curNode->longTermSch.erase(it);
+            }
+            else
+                curNode->ltsGeneration++; // The job can be reserved again, so regions cached as misses are worth a new look
+            return;
+        }
+    }
+}
+
+/*
+**                      startSwapIn(0)
+**
+**    Starts swapping in the front of the STS if the drum
+**    is idle, so a job that just got memory does not wait
+**    for the next interrupt to be loaded
+*/
+void startSwapIn()
+{
+    if(!curNode->shortTermSch.empty() && !curNode->drumBusy) {
+        PCB temp(curNode->shortTermSch.front());
+        siodrum(temp[job_number], temp[job_size], temp[core_addr], 0);
+        curNode->drumBusy = true;
+    }
+}
+
+
+/*
+**                      takeWaitingJob(2)
+**
+**    Used to move jobs between machines. Removes the first
+**    job in LTS order whose size is at most maxSize from
+**    this machine's LTS and copies it into job. Returns
+**    false if no waiting job is small enough
+*/
+bool takeWaitingJob(long maxSize, PCB &job)
+{
+    LTSMap::iterator it;
+	
+    for(it = curNode->longTermSch.begin(); it != curNode->longTermSch.end(); it++) {
+        if((it->second)[job_size] <= maxSize) {
+            job = it->second;
+            curNode->longTermSch.erase(it);
+            dropReservation(job[job_number]);
+            return true;
+        }
+    }
+	
+    return false;
+}
+
+/*
+**                      acceptJob(1)
+**
+**    Admits a job that was moved here from another
+**    machine. Since no interrupt is running on this
+**    machine, the swap-in is started here if the drum
+**    is free
+*/
+void acceptJob(PCB &job)
+{
+    admitJob(job);
+    startSwapIn();
+}
+
 
 void moveJobPtr()
 {
-	if(cpuReadyQueue.size() > 1)
-		if(runningJob  == --cpuReadyQueue.end())
-			runningJob = cpuReadyQueue.begin();
+	if(curNode->cpuReadyQueue.size() > 1)
+		if(curNode->runningJob  == --curNode->cpuReadyQueue.end())
+			curNode->runningJob = curNode->cpuReadyQueue.begin();
 		else
-			runningJob++;
+			curNode->runningJob++;
 }
 
 void testFunc(int val)
@@ -491,12 +684,12 @@ void testFunc(int val)
     }
 	
     cout << "===================== Value in CPU RQ ========================" << endl;
-    if(cpuReadyQueue.empty())
+    if(curNode->cpuReadyQueue.empty())
         cout << "CPU Queue Empty" << endl << endl;
 		
-    list<PCB>::iterator it;
+    PCBList::iterator it;
 	
-    for(it = cpuReadyQueue.begin(); it != cpuReadyQueue.end(); it++) {
+    for(it = curNode->cpuReadyQueue.begin(); it != curNode->cpuReadyQueue.end(); it++) {
         cout << "Job number: " << (*it)[job_number] << endl;
         cout << "Job Address: " << (*it)[core_addr] << endl;
         cout << "Blocked: " << it->isBlocked() << endl;
@@ -510,21 +703,21 @@ void testFunc(int val)
     }
 	
     cout << "===================== Value in IO Queue ========================" << endl;
-    if(ioQueue.empty())
+    if(curNode->ioQueue.empty())
         cout << "IO Queue Empty" << endl << endl;
 		
-    for(it = ioQueue.begin(); it != ioQueue.end(); it++)
+    for(it = curNode->ioQueue.begin(); it != curNode->ioQueue.end(); it++)
 		cout << "Job Number: " << (*it)[job_number] << endl;
 		
     cout << endl;
 	
     cout << "===================== Value in LTS ========================" << endl;
-    if(longTermSch.empty())
+    if(curNode->longTermSch.empty())
         cout << "LTS Empty" << endl << endl;
 		
-    multimap<long, PCB, greater<long> >::iterator imp;
+    LTSMap::iterator imp;
 	
-    for(imp = longTermSch.begin(); imp != longTermSch.end(); imp++)
+    for(imp = curNode->longTermSch.begin(); imp != curNode->longTermSch.end(); imp++)
 		cout << "Job Number" << (imp->second)[job_number] << endl;
 		
     cout << endl;
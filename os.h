@@ -5,22 +5,40 @@
 #include <queue>
 #include <functional>
 #include <list>
+#include <vector>
 #include <iostream>
+#include <memory_resource>
+#include <atomic>
+#include <coroutine>
+#include <exception>
 
 using namespace std;
 
+// Size of the inline scratch buffers that back per-call temporaries
+#define SCRATCH_BYTES	8192
+
+// A terminated job with at most this many IOs left has its region reserved for an LTS job
+#define RESERVE_IO_LIMIT	1
+
 /***************************
 **     Memory Manager     **
 ****************************/
 
+typedef pmr::multimap<long, long, less<long> > FSTable;
+
 class MemoryManager {
 	private:
-		multimap<long, long , less<long> > fsTable; // Free-Space Table
+		pmr::unsynchronized_pool_resource pool; // Backs the nodes of fsTable
+		char scratchBuf[SCRATCH_BYTES];
+		pmr::monotonic_buffer_resource scratch; // Reset on every defragment() call
+		FSTable fsTable; // Free-Space Table
 	public:
 		MemoryManager();
 		void insertInTable(pair<long, long>); // Inserts the job and it's size into table
 		pair<long, long> findSpace(long); // Check for free space for a given job size
 		void defragment(); // Defrag table to check for adjacent free-space chunks
+		const FSTable & getTable() { return fsTable; } // Read-only view used by checkpoints
+		void clearTable() { fsTable.clear(); } // Empties the table before a checkpoint is restored
 };
 
 
@@ -28,6 +46,25 @@ class MemoryManager {
 **     PCB (Job class)     **
 *****************************/
 
+// Flat image of a PCB as it is stored inside a checkpoint file (all longs, so there is no padding)
+struct PCBRecord {
+	long jobNumber;
+	long priority;
+	long jobSize;
+	long timeRemaining;
+	long timeOfArrival;
+	long jobAddr;
+	long pendingIOcnt;
+	long startingTimeExec;
+	long ioCnt;
+	
+	long pendingIO;
+	long blocked;
+	long doingIO;
+	long terminated;
+	long jobRunning;
+};
+
 class PCB {
 	private:
 		// Job properties are stored here
@@ -50,10 +87,18 @@ class PCB {
 		// Constructor that intilaizes all values
 		PCB(long jNum = -1, long p = -1, long jSize = -1, long tR = -1, long tA = -1, long jAddr = -1):
 		jobNumber(jNum), priority(p), jobSize(jSize), timeRemaining(tR), timeOfArrival(tA), jobAddr(jAddr),
-		blocked(false), doingIO(false), pendingIO(false), terminated(false),startingTimeExec(0), ioCnt(0),
+		pendingIOcnt(0), blocked(false), doingIO(false), pendingIO(false), terminated(false),startingTimeExec(0), ioCnt(0),
 		jobRunning(false)
 		{}
 		
+		// Constructor that rebuilds a job from a checkpoint record
+		PCB(const PCBRecord &rec):
+		jobNumber(rec.jobNumber), priority(rec.priority), jobSize(rec.jobSize), timeRemaining(rec.timeRemaining),
+		timeOfArrival(rec.timeOfArrival), jobAddr(rec.jobAddr), pendingIOcnt(rec.pendingIOcnt),
+		startingTimeExec(rec.startingTimeExec), ioCnt(rec.ioCnt), pendingIO(rec.pendingIO), blocked(rec.blocked),
+		doingIO(rec.doingIO), terminated(rec.terminated), jobRunning(rec.jobRunning)
+		{}
+		
 		// Destructor
 		~PCB() {}
 		
@@ -65,6 +110,7 @@ class PCB {
 			this->timeRemaining = rObj.timeRemaining;
 			this->timeOfArrival = rObj.timeOfArrival;
 			this->jobAddr = rObj.jobAddr;
+			this->pendingIOcnt = rObj.pendingIOcnt;
 			this->blocked = rObj.blocked;
             this->ioCnt = rObj.ioCnt;
             this->doingIO = rObj.doingIO;
@@ -83,6 +129,7 @@ class PCB {
 			this->timeRemaining = rObj[4];
 			this->timeOfArrival = rObj[5];
 			this->jobAddr = rObj[6];
+			this->pendingIOcnt = rObj.pendingIOcnt;
 			this->blocked = rObj.blocked;
             this->doingIO = rObj.doingIO;
             this->pendingIO = rObj.pendingIO;
@@ -122,6 +169,11 @@ class PCB {
         bool isPendingIO() {return pendingIO; }
         bool isTerminated() { return terminated; }
         bool isRunning() { return jobRunning; }
+        PCBRecord getRecord() const { // Returns the flat image written to checkpoints
+			PCBRecord rec = { jobNumber, priority, jobSize, timeRemaining, timeOfArrival, jobAddr,
+							  pendingIOcnt, startingTimeExec, ioCnt, pendingIO, blocked, doingIO, terminated, jobRunning };
+			return rec;
+		}
 		
 		//Mutators
 		void setBlocked(bool value) { blocked = value; }
@@ -138,4 +190,175 @@ class PCB {
         void setJobRunning(bool rn) { jobRunning = rn; }
 };
 
+
+/****************************
+**     Simulator State     **
+*****************************/
+
+// Scheduler containers draw their nodes from their machine's pool instead of the global heap
+typedef pmr::list<PCB> PCBList;
+typedef queue<PCB, pmr::deque<PCB> > PCBQueue;
+typedef pmr::multimap<long, PCB, less<long> > LTSMap;
+typedef pmr::map<long, long, less<long> > ReservationMap;
+
+// Everything one simulated machine owns. The interrupt handlers work on curNode
+struct Node {
+	pmr::unsynchronized_pool_resource pool; // Recycles queue nodes for this machine
+	char interruptScratchBuf[SCRATCH_BYTES];
+	pmr::monotonic_buffer_resource interruptScratch; // Reset once per interrupt
+	
+	MemoryManager memManager; // Representation of FST
+	PCBList cpuReadyQueue; // List of jobs that are capable of running on CPU & other operations
+	PCBList ioQueue; // Queue of jobs asking for IO (Each job can have more than one instance)
+	PCBList::iterator runningJob; // Pointer to job that is currently running
+	PCBQueue shortTermSch; // Jobs that found space in memory, but have not been swapped by the drum yet
+	LTSMap longTermSch; // LTS that sorts jobs by maxCPUTime when they do not find space in memory
+	ReservationMap reservations; // Core address of a terminating job -> LTS job swapped in when it is freed
+	ReservationMap reserveMisses; // Core address -> ltsGeneration when no LTS job could be reserved for it
+	long ltsGeneration; // Bumped whenever the LTS gains a job that could be reserved
+	
+	bool drumBusy; // Semaphore to check if drum is in use (Swapping a job in core)
+	bool diskBusy; // Semaphore to check if disk is in use (A job is currently doing IO)
+	
+	Node();
+};
+
+// Defined in os.cpp
+extern pmr::synchronized_pool_resource simPool; // Simulation-wide allocations (job scripts)
+extern thread_local Node *curNode; // Machine the next interrupt on this thread is raised on
+extern long TIME_SLICE;
+extern bool reserveRegions;
+
+void admitJob(PCB &newJob); // Puts a new job on the STS if it fits in memory, otherwise on the LTS
+bool takeWaitingJob(long maxSize, PCB &job); // Removes the first LTS job that fits in maxSize
+void acceptJob(PCB &job); // Admits a job moved from another machine and starts its swap-in
+void dropReservation(long jobNum); // Frees the region reserved for a job that left the LTS
+
+
+/****************************
+**       Checkpoints       **
+*****************************/
+
+bool saveCheckpoint(const char *fileName, long clock, const vector<Node *> &nodes); // Writes every machine's state to a binary snapshot
+bool restoreCheckpoint(const char *fileName, long &clock, const vector<Node *> &nodes); // Replaces every machine's state with a snapshot
+
+
+
+/****************************
+**        Job Feed         **
+*****************************/
+
+#define JOB_RING_SIZE	4096 // Must be a power of two
+
+// One job as it arrives from the live feed (same fields Crint(2) gets in p[1..5])
+struct JobRecord {
+	long jobNumber;
+	long priority;
+	long jobSize;
+	long maxCPUTime;
+	long timeOfArrival;
+};
+
+// Lock-free ring with exactly one producer thread and one consumer thread
+class JobRing {
+	private:
+		JobRecord slots[JOB_RING_SIZE];
+		alignas(64) atomic<unsigned long> head; // Next slot to read, only written by the consumer
+		alignas(64) atomic<unsigned long> tail; // Next slot to write, only written by the producer
+	public:
+		JobRing(): head(0), tail(0) {}
+		bool push(const JobRecord &); // Producer side. Returns false if the ring is full
+		bool peek(JobRecord &); // Consumer side. Copies the oldest record without removing it
+		void pop(); // Consumer side. Drops the record returned by peek
+		bool empty() { return head.load(memory_order_acquire) == tail.load(memory_order_acquire); }
+};
+
+bool startJobFeed(const char *fileName, long usecPerTick); // Opens the feed and starts the feeder thread (usecPerTick 0 = as fast as possible)
+void stopJobFeed(); // Stops the feeder thread and waits for it
+bool takeFedJob(long before, JobRecord &rec); // Removes the oldest fed job if it arrives before the given time. Never blocks
+bool nextFeedArrival(long &arrival); // Arrival time of the oldest job waiting in the ring, if any
+bool waitFeedJob(long &arrival); // Blocks until a job is in the ring (true) or the feed is finished (false)
+long feedClock(); // Tick the wall clock has reached since a paced feed started, 0 if not paced
+void waitFeedClock(long tick); // Sleeps until the wall clock reaches tick of a paced feed
+bool jobFeedFinished(); // True once the feeder has read everything and the ring is empty
+
+
+/****************************
+**       Job Scripts       **
+*****************************/
+
+// Action kinds double as the Svc(2) request a job makes once its burst is over
+#define JOB_CPU		0 // Run on the CPU for amount ticks
+#define JOB_IO		6 // Request one IO that keeps the disk busy for amount ticks
+#define JOB_BLOCK	7 // Block until all of the job's IO has completed
+
+struct JobAction {
+	long kind;
+	long amount;
+};
+
+inline JobAction cpuBurst(long ticks) { JobAction act = { JOB_CPU, ticks }; return act; }
+inline JobAction ioRequest(long ticks) { JobAction act = { JOB_IO, ticks }; return act; }
+inline JobAction blockRequest() { JobAction act = { JOB_BLOCK, 0 }; return act; }
+
+// A job's behaviour written as a coroutine that co_yields JobActions and
+// co_returns when it wants to terminate (Svc 5). The driver resumes it once
+// per action, so a suspended job costs only its coroutine frame, which comes
+// from simPool like every other per-job allocation
+class JobProgram {
+	public:
+		struct promise_type {
+			JobAction current;
+			
+			JobProgram get_return_object() { return JobProgram(coroutine_handle<promise_type>::from_promise(*this)); }
+			suspend_always initial_suspend() noexcept { return suspend_always(); }
+			suspend_always final_suspend() noexcept { return suspend_always(); }
+			suspend_always yield_value(JobAction act) { current = act; return suspend_always(); }
+			void return_void() {}
+			void unhandled_exception() { terminate(); }
+			
+			static void * operator new(size_t size) { return simPool.allocate(size); }
+			static void operator delete(void *frame, size_t size) { simPool.deallocate(frame, size); }
+		};
+		
+		JobProgram(): handle(nullptr) {}
+		explicit JobProgram(coroutine_handle<promise_type> h): handle(h) {}
+		JobProgram(JobProgram &&rObj) noexcept: handle(rObj.handle) { rObj.handle = nullptr; }
+		JobProgram & operator =(JobProgram &&rObj) noexcept {
+			if(this != &rObj) {
+				release();
+				handle = rObj.handle;
+				rObj.handle = nullptr;
+			}
+			return *this;
+		}
+		JobProgram(const JobProgram &) = delete;
+		~JobProgram() { release(); }
+		
+		// Resumes the job until its next action. Returns false once the job has terminated
+		bool next(JobAction &act) {
+			if(!handle || handle.done())
+				return false;
+			handle.resume();
+			if(handle.done())
+				return false;
+			act = handle.promise().current;
+			return true;
+		}
+		
+		// False before the program is made and after release()
+		bool loaded() const { return handle != nullptr; }
+		
+		// Frees the coroutine frame
+		void release() {
+			if(handle)
+				handle.destroy();
+			handle = nullptr;
+		}
+	private:
+		coroutine_handle<promise_type> handle;
+};
+
+JobProgram makeJobProgram(long jobNumber, long maxCPUTime, unsigned long seed); // Picks a behaviour profile for a job
+
 #endif
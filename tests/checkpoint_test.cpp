@@ -0,0 +1,143 @@
+/*******     Checkpoint Test     *******/
+
+
+#include "os.h"
+
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+/*
+**	Saves the OS state of two machines, restores it into
+**	two fresh machines and saves those again. Both files
+**	must hold the same bytes. Also checks that a snapshot
+**	is turned down for the wrong number of machines or
+**	when it is cut short, and that the machines it was
+**	turned down for keep their state.
+**	Builds without the driver:
+**		g++ -std=c++20 -pthread -I. tests/checkpoint_test.cpp os.cpp memmanger.cpp checkpoint.cpp -o checkpoint_test
+*/
+
+// The OS only starts devices and switches tracing, so these record nothing
+void siodisk(long) {}
+void siodrum(long, long, long, long) {}
+void ontrace() {}
+void offtrace() {}
+
+// Defined in os.cpp
+void Crint(long &a, long p[]);
+void Drmint(long &a, long p[]);
+void Svc(long &a, long p[]);
+void startup();
+
+int failures = 0;
+
+/*
+**			check(2)
+**	-Inputs:
+**		bool ok, const char *what
+**	-Description:
+**		Counts and reports a check that did not hold
+**	-Output:
+**		none
+*/
+void check(bool ok, const char *what)
+{
+	if(!ok) {
+		cerr << "FAILED: " << what << endl;
+		failures++;
+	}
+}
+
+/*
+**			readFile(1)
+**	-Inputs:
+**		const string &fileName
+**	-Description:
+**		Reads a whole file
+**	-Output:
+**		the file's bytes, empty if it cannot be read
+*/
+string readFile(const string &fileName)
+{
+	ifstream in(fileName.c_str(), ios::binary);
+	return string((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+}
+
+/*
+**			fillNode(2)
+**	-Inputs:
+**		Node *node, long firstJob
+**	-Description:
+**		Raises interrupts on node until its free space
+**		table, ready, IO, short term and long term queues
+**		all hold something: four jobs arrive, two fit in
+**		memory and two wait on the LTS, the drum swaps the
+**		first one in and it asks for an IO
+**	-Output:
+**		none
+*/
+void fillNode(Node *node, long firstJob)
+{
+	long sizes[4] = { 30, 40, 50, 60 };
+	long a = 0, p[6];
+
+	curNode = node;
+	startup();
+	for(long k = 0; k < 4; k++) {
+		p[1] = firstJob + k;
+		p[2] = k + 1;
+		p[3] = sizes[k];
+		p[4] = 1000 + 100 * k;
+		p[5] = 10 * k;
+		Crint(a, p);
+	}
+
+	p[5] = 50;
+	Drmint(a, p);
+	a = 6;
+	p[5] = 60;
+	Svc(a, p);
+}
+
+int main()
+{
+	string first = "checkpoint_test.ckpt", second = "checkpoint_test.ckpt.again", cut = "checkpoint_test.ckpt.cut";
+	Node saved[2], restored[2];
+	vector<Node *> savedNodes = { &saved[0], &saved[1] };
+	vector<Node *> restoredNodes = { &restored[0], &restored[1] };
+	long clock = 0;
+
+	fillNode(&saved[0], 1);
+	fillNode(&saved[1], 11);
+	check(!saved[0].cpuReadyQueue.empty() && !saved[0].ioQueue.empty() && !saved[0].shortTermSch.empty()
+		  && !saved[0].longTermSch.empty(), "the interrupts fill every queue");
+
+	check(saveCheckpoint(first.c_str(), 1234, savedNodes), "save two machines");
+	check(restoreCheckpoint(first.c_str(), clock, restoredNodes), "restore two machines");
+	check(clock == 1234, "the clock comes back");
+	check(saveCheckpoint(second.c_str(), clock, restoredNodes), "save the restored machines");
+	check(readFile(first) != "" && readFile(first) == readFile(second), "save, restore, save gives the same bytes");
+
+	vector<Node *> oneNode = { &restored[0] };
+	check(!restoreCheckpoint(first.c_str(), clock, oneNode), "a snapshot of two machines does not restore into one");
+
+	string bytes = readFile(first);
+	ofstream(cut.c_str(), ios::binary).write(bytes.data(), bytes.size() - 1);
+	check(!restoreCheckpoint(cut.c_str(), clock, restoredNodes), "a snapshot cut short does not restore");
+
+	check(saveCheckpoint(second.c_str(), clock, restoredNodes) && readFile(first) == readFile(second),
+		  "a snapshot that is turned down leaves the machines alone");
+
+	unlink(first.c_str());
+	unlink(second.c_str());
+	unlink(cut.c_str());
+
+	if(failures)
+		return 1;
+	cout << "checkpoint test passed" << endl;
+	return 0;
+}
+
+
+/*******     End Checkpoint Test     *******/